@@ -0,0 +1,91 @@
+#include "comp6771/batch_scorer.hpp"
+
+#include "comp6771/euclidean_vector.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <latch>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+	auto random_vector(std::mt19937_64& rng, int dimensions) -> comp6771::euclidean_vector {
+		auto dist = std::uniform_real_distribution<double>(-1.0, 1.0);
+		auto v = comp6771::euclidean_vector(dimensions);
+		for (auto i = 0; i < dimensions; ++i) {
+			v[i] = dist(rng);
+		}
+		return v;
+	}
+
+	auto handle(comp6771::batch_scorer& scorer, comp6771::euclidean_vector query, std::latch& done)
+	   -> comp6771::detached_task {
+		auto const result = co_await scorer.score(std::move(query));
+		static_cast<void>(result);
+		done.count_down();
+	}
+
+	auto argument(int argc, char** argv, int i, long fallback) -> long {
+		return i < argc ? std::stol(argv[i]) : fallback;
+	}
+} // namespace
+
+// usage: batch_scorer_load [rate/s] [requests] [max_batch] [deadline us] [threads] [model size]
+//                          [dimensions]
+auto main(int argc, char** argv) -> int {
+	auto const rate = argument(argc, argv, 1, 20'000);
+	auto const requests = argument(argc, argv, 2, 100'000);
+	auto opts = comp6771::batch_scorer::options{};
+	opts.max_batch = static_cast<std::size_t>(argument(argc, argv, 3, 64));
+	opts.deadline = std::chrono::microseconds(argument(argc, argv, 4, 200));
+	opts.threads = static_cast<unsigned>(argument(argc, argv, 5, 2));
+	auto const model_size = argument(argc, argv, 6, 1024);
+	auto const dimensions = static_cast<int>(argument(argc, argv, 7, 64));
+
+	auto rng = std::mt19937_64(6771);
+	auto model = std::vector<comp6771::euclidean_vector>();
+	model.reserve(static_cast<std::size_t>(model_size));
+	for (auto i = 0L; i < model_size; ++i) {
+		model.push_back(random_vector(rng, dimensions));
+	}
+	auto queries = std::vector<comp6771::euclidean_vector>();
+	queries.reserve(1024);
+	for (auto i = 0; i < 1024; ++i) {
+		queries.push_back(random_vector(rng, dimensions));
+	}
+
+	auto done = std::latch(requests);
+	{
+		auto scorer = comp6771::batch_scorer(std::move(model), opts);
+		auto const interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		   std::chrono::duration<double>(1.0 / static_cast<double>(rate)));
+		auto const start = std::chrono::steady_clock::now();
+		for (auto i = 0L; i < requests; ++i) {
+			std::this_thread::sleep_until(start + i * interval);
+			handle(scorer, queries[static_cast<std::size_t>(i) % queries.size()], done);
+		}
+		done.wait();
+		auto const elapsed = std::chrono::steady_clock::now() - start;
+
+		auto const h = scorer.latencies();
+		auto const micros = [&h](double p) {
+			return std::chrono::duration<double, std::micro>(h.percentile(p)).count();
+		};
+		auto const seconds = std::chrono::duration<double>(elapsed).count();
+		fmt::print("requests     {}\n", h.count());
+		fmt::print("throughput   {:.0f}/s (target {}/s)\n",
+		           static_cast<double>(requests) / seconds,
+		           rate);
+		fmt::print("batches      {} (mean size {:.1f})\n",
+		           scorer.batches(),
+		           static_cast<double>(requests) / static_cast<double>(scorer.batches()));
+		fmt::print("p50          {:.1f}us\n", micros(50));
+		fmt::print("p90          {:.1f}us\n", micros(90));
+		fmt::print("p99          {:.1f}us\n", micros(99));
+		fmt::print("p99.9        {:.1f}us\n", micros(99.9));
+	}
+	return EXIT_SUCCESS;
+}
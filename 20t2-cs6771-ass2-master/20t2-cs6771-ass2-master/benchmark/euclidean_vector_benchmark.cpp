@@ -0,0 +1,226 @@
+#include "comp6771/euclidean_vector.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+namespace {
+	using size_type = comp6771::euclidean_vector::size_type;
+
+	// Every benchmark sweeps the same dimensions: 2, 16, 128, ..., 1M.
+	auto dimensions(benchmark::internal::Benchmark* b) -> void {
+		b->RangeMultiplier(8)->Range(2, size_type{1} << 20);
+	}
+
+	auto make_vector(size_type n) -> comp6771::euclidean_vector {
+		auto magnitudes = std::vector<double>(static_cast<std::size_t>(n));
+		std::iota(magnitudes.begin(), magnitudes.end(), 1.0);
+		return comp6771::euclidean_vector(magnitudes.begin(), magnitudes.end());
+	}
+
+	// Reports how many bytes of magnitudes each iteration streams through, counting every
+	// vector read and every vector written.
+	auto set_bytes(benchmark::State& state, std::int64_t vectors_touched) -> void {
+		state.SetBytesProcessed(state.iterations() * state.range(0) * vectors_touched
+		                        * static_cast<std::int64_t>(sizeof(double)));
+	}
+
+	auto construct_filled(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto v = comp6771::euclidean_vector(state.range(0), 1.5);
+			benchmark::DoNotOptimize(v);
+		}
+		set_bytes(state, 1);
+	}
+	BENCHMARK(construct_filled)->Apply(dimensions);
+
+	auto construct_iterators(benchmark::State& state) -> void {
+		auto const magnitudes = std::vector<double>(static_cast<std::size_t>(state.range(0)), 1.5);
+		for (auto _ : state) {
+			auto v = comp6771::euclidean_vector(magnitudes.begin(), magnitudes.end());
+			benchmark::DoNotOptimize(v);
+		}
+		set_bytes(state, 2);
+	}
+	BENCHMARK(construct_iterators)->Apply(dimensions);
+
+	auto construct_initializer_list(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			auto v = comp6771::euclidean_vector{1.0, 2.0, 3.0, 4.0};
+			benchmark::DoNotOptimize(v);
+		}
+	}
+	BENCHMARK(construct_initializer_list);
+
+	auto copy(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		for (auto _ : state) {
+			auto c = v;
+			benchmark::DoNotOptimize(c);
+		}
+		set_bytes(state, 2);
+	}
+	BENCHMARK(copy)->Apply(dimensions);
+
+	auto move(benchmark::State& state) -> void {
+		auto v = make_vector(state.range(0));
+		for (auto _ : state) {
+			auto m = std::move(v);
+			benchmark::DoNotOptimize(m);
+			v = std::move(m);
+		}
+	}
+	BENCHMARK(move)->Apply(dimensions);
+
+	auto unary_plus(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(+v);
+		}
+		set_bytes(state, 2);
+	}
+	BENCHMARK(unary_plus)->Apply(dimensions);
+
+	auto negate(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(-v);
+		}
+		set_bytes(state, 2);
+	}
+	BENCHMARK(negate)->Apply(dimensions);
+
+	auto add_assign(benchmark::State& state) -> void {
+		auto v = make_vector(state.range(0));
+		auto const w = make_vector(state.range(0));
+		for (auto _ : state) {
+			v += w;
+			benchmark::ClobberMemory();
+		}
+		set_bytes(state, 3);
+	}
+	BENCHMARK(add_assign)->Apply(dimensions);
+
+	auto subtract_assign(benchmark::State& state) -> void {
+		auto v = make_vector(state.range(0));
+		auto const w = make_vector(state.range(0));
+		for (auto _ : state) {
+			v -= w;
+			benchmark::ClobberMemory();
+		}
+		set_bytes(state, 3);
+	}
+	BENCHMARK(subtract_assign)->Apply(dimensions);
+
+	auto multiply_assign(benchmark::State& state) -> void {
+		auto v = make_vector(state.range(0));
+		for (auto _ : state) {
+			v *= 1.0;
+			benchmark::ClobberMemory();
+		}
+		set_bytes(state, 2);
+	}
+	BENCHMARK(multiply_assign)->Apply(dimensions);
+
+	auto divide_assign(benchmark::State& state) -> void {
+		auto v = make_vector(state.range(0));
+		for (auto _ : state) {
+			v /= 1.0;
+			benchmark::ClobberMemory();
+		}
+		set_bytes(state, 2);
+	}
+	BENCHMARK(divide_assign)->Apply(dimensions);
+
+	auto add(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		auto const w = make_vector(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(v + w);
+		}
+		set_bytes(state, 3);
+	}
+	BENCHMARK(add)->Apply(dimensions);
+
+	auto subtract(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		auto const w = make_vector(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(v - w);
+		}
+		set_bytes(state, 3);
+	}
+	BENCHMARK(subtract)->Apply(dimensions);
+
+	auto multiply(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(v * 2.0);
+			benchmark::DoNotOptimize(2.0 * v);
+		}
+		set_bytes(state, 4);
+	}
+	BENCHMARK(multiply)->Apply(dimensions);
+
+	auto divide(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(v / 2.0);
+		}
+		set_bytes(state, 2);
+	}
+	BENCHMARK(divide)->Apply(dimensions);
+
+	auto dot(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		auto const w = make_vector(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::dot(v, w));
+		}
+		set_bytes(state, 2);
+	}
+	BENCHMARK(dot)->Apply(dimensions);
+
+	// Writing through operator[] invalidates the cached norm, so every iteration recomputes it.
+	auto euclidean_norm_cold(benchmark::State& state) -> void {
+		auto v = make_vector(state.range(0));
+		for (auto _ : state) {
+			v[0] = 1.0;
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		}
+		set_bytes(state, 1);
+	}
+	BENCHMARK(euclidean_norm_cold)->Apply(dimensions);
+
+	auto euclidean_norm_warm(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::euclidean_norm(v));
+		}
+	}
+	BENCHMARK(euclidean_norm_warm)->Apply(dimensions);
+
+	auto unit(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(comp6771::unit(v));
+		}
+		set_bytes(state, 2);
+	}
+	BENCHMARK(unit)->Apply(dimensions);
+
+	auto output_stream(benchmark::State& state) -> void {
+		auto const v = make_vector(state.range(0));
+		for (auto _ : state) {
+			auto os = std::ostringstream();
+			os << v;
+			benchmark::DoNotOptimize(os.str());
+		}
+		set_bytes(state, 1);
+	}
+	BENCHMARK(output_stream)->Apply(dimensions);
+} // namespace
@@ -0,0 +1,136 @@
+#ifndef COMP6771_BATCH_SCORER_HPP
+#define COMP6771_BATCH_SCORER_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace comp6771 {
+	// Log-linear latency buckets: exact below 16ns, then 16 buckets per power of two, so any
+	// reported percentile is within 1/16 of the true value.
+	class latency_histogram {
+	public:
+		auto record(std::chrono::nanoseconds latency) noexcept -> void;
+		auto merge(latency_histogram const& other) noexcept -> void;
+		[[nodiscard]] auto count() const noexcept -> std::uint64_t;
+		// The upper bound of the bucket holding the p-th percentile, for p in [0, 100].
+		[[nodiscard]] auto percentile(double p) const noexcept -> std::chrono::nanoseconds;
+
+	private:
+		static constexpr auto sub_buckets = std::size_t{16};
+		static constexpr auto bucket_count = sub_buckets * 61;
+
+		std::array<std::uint64_t, bucket_count> counts_ = {};
+		std::uint64_t count_ = 0;
+	};
+
+	struct score_result {
+		// dots[i] is the dot product of the query with the i-th model vector.
+		std::vector<double> dots;
+		double norm;
+	};
+
+	// Collects queries that arrive one at a time into micro-batches, and scores each batch
+	// against a fixed model on a thread pool. A batch closes when it reaches max_batch or when
+	// its oldest query has waited `deadline`, whichever comes first. Awaiting coroutines are
+	// resumed on the pool thread that scored their batch. Destroying the scorer flushes every
+	// pending query.
+	class batch_scorer {
+	public:
+		struct options {
+			std::size_t max_batch = 64;
+			std::chrono::microseconds deadline = std::chrono::microseconds(200);
+			unsigned threads = 2;
+		};
+
+		class awaitable;
+
+		explicit batch_scorer(std::vector<euclidean_vector> model);
+		batch_scorer(std::vector<euclidean_vector> model, options opts);
+		batch_scorer(batch_scorer const&) = delete;
+		batch_scorer(batch_scorer&&) = delete;
+		~batch_scorer();
+		auto operator=(batch_scorer const&) -> batch_scorer& = delete;
+		auto operator=(batch_scorer&&) -> batch_scorer& = delete;
+
+		// The query is kept in the awaitable until its batch is scored. Throws if the query has no
+		// dimensions or doesn't match the model's.
+		[[nodiscard]] auto score(euclidean_vector query) -> awaitable;
+
+		// Time from score() being awaited to the result being ready, for every completed query.
+		[[nodiscard]] auto latencies() const -> latency_histogram;
+		[[nodiscard]] auto batches() const -> std::uint64_t;
+
+	private:
+		struct state;
+
+		struct request {
+			euclidean_vector query;
+			score_result result;
+			std::coroutine_handle<> waiter;
+			std::chrono::steady_clock::time_point enqueued;
+		};
+
+		auto enqueue(request& r) -> void;
+
+		std::unique_ptr<state> state_;
+
+	public:
+		class awaitable {
+		public:
+			[[nodiscard]] auto await_ready() const noexcept -> bool {
+				return false;
+			}
+
+			auto await_suspend(std::coroutine_handle<> waiter) -> void {
+				request_.waiter = waiter;
+				scorer_->enqueue(request_);
+			}
+
+			auto await_resume() -> score_result {
+				return std::move(request_.result);
+			}
+
+		private:
+			friend class batch_scorer;
+
+			awaitable(batch_scorer& scorer, euclidean_vector query)
+			: scorer_{&scorer}
+			, request_{std::move(query), {}, {}, {}} {}
+
+			batch_scorer* scorer_;
+			request request_;
+		};
+	};
+
+	// A coroutine return type for request handlers that nobody joins. It starts running
+	// immediately and frees its frame when it finishes.
+	struct detached_task {
+		struct promise_type {
+			auto get_return_object() noexcept -> detached_task {
+				return {};
+			}
+
+			auto initial_suspend() noexcept -> std::suspend_never {
+				return {};
+			}
+
+			auto final_suspend() noexcept -> std::suspend_never {
+				return {};
+			}
+
+			auto return_void() noexcept -> void {}
+
+			auto unhandled_exception() noexcept -> void {
+				std::terminate();
+			}
+		};
+	};
+} // namespace comp6771
+#endif // COMP6771_BATCH_SCORER_HPP
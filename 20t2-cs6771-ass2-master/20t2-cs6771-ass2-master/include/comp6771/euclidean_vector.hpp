@@ -2,12 +2,19 @@
 #define COMP6771_EUCLIDEAN_VECTOR_HPP
 
 #include "gsl-lite/gsl-lite.hpp"
+#include <array>
+#include <cmath>
 #include <compare>
+#include <cstddef>
+#include <cstdint>
 #include <fmt/format.h>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <ostream>
 #include <range/v3/algorithm.hpp>
 #include <range/v3/iterator.hpp>
@@ -17,7 +24,38 @@
 #include <string_view>
 #include <vector>
 
+// Define as 1 (the COMP6771_EUCLIDEAN_VECTOR_ENABLE_STATS CMake option does this for every
+// target) to count allocations, copies, moves and norm cache hits. Left at 0 the hooks compile
+// away entirely.
+#ifndef COMP6771_EUCLIDEAN_VECTOR_STATS
+#	define COMP6771_EUCLIDEAN_VECTOR_STATS 0
+#endif
+
 namespace comp6771 {
+	inline constexpr auto stats_enabled = bool{COMP6771_EUCLIDEAN_VECTOR_STATS};
+
+	// Totals across every thread since the last reset_stats().
+	struct euclidean_vector_stats {
+		std::uint64_t allocations = 0;
+		std::uint64_t copies = 0;
+		std::uint64_t moves = 0;
+		std::uint64_t norm_cache_hits = 0;
+		std::uint64_t norm_cache_misses = 0;
+	};
+
+	auto stats_snapshot() -> euclidean_vector_stats;
+	auto reset_stats() -> void;
+
+	namespace detail {
+		enum class stat { allocation, copy, move, norm_cache_hit, norm_cache_miss };
+
+#if COMP6771_EUCLIDEAN_VECTOR_STATS
+		auto record(stat s) noexcept -> void;
+#else
+		inline auto record(stat) noexcept -> void {}
+#endif
+	} // namespace detail
+
 	class euclidean_vector_error : public std::runtime_error {
 	public:
 		explicit euclidean_vector_error(std::string const& what) noexcept
@@ -26,19 +64,21 @@ namespace comp6771 {
 
 	class euclidean_vector {
 	public:
+		using size_type = std::ptrdiff_t;
+
 		euclidean_vector();
-		explicit euclidean_vector(int);
-		euclidean_vector(int dimensions, double magnitude);
+		explicit euclidean_vector(size_type);
+		euclidean_vector(size_type dimensions, double magnitude);
 		euclidean_vector(std::vector<double>::const_iterator start,
 		                 std::vector<double>::const_iterator end);
 		euclidean_vector(std::initializer_list<double>);
 		euclidean_vector(euclidean_vector const&);
 		euclidean_vector(euclidean_vector&& a) noexcept;
-		~euclidean_vector() = default;
+		~euclidean_vector();
 		auto operator=(euclidean_vector const&) -> euclidean_vector&;
 		auto operator=(euclidean_vector&&) noexcept -> euclidean_vector&;
-		auto operator[](int i) noexcept -> double&;
-		auto operator[](int i) const noexcept -> double;
+		auto operator[](size_type i) noexcept -> double&;
+		auto operator[](size_type i) const noexcept -> double;
 		auto operator+() const -> euclidean_vector;
 		auto operator-() const -> euclidean_vector;
 		auto operator+=(euclidean_vector const&) -> euclidean_vector&;
@@ -47,22 +87,32 @@ namespace comp6771 {
 		auto operator/=(double) -> euclidean_vector&;
 		explicit operator std::vector<double>() const;
 		explicit operator std::list<double>() const;
-		[[nodiscard]] auto at(int) const -> double;
-		auto at(int) -> double&;
-		[[nodiscard]] auto dimensions() const noexcept -> int;
-		friend auto operator==(euclidean_vector const& a, euclidean_vector const& b) -> bool {
-			if (a.dimensions() != b.dimensions()) {
-				return false;
-			}
-
-			return std::equal(a.span_.begin(),
-			                  a.span_.end(),
-			                  b.span_.begin(),
-			                  [](double const& l, double const& r) -> bool {
-				                  return (std::fabs(l - r) <= std::numeric_limits<double>::epsilon());
-			                  });
+		[[nodiscard]] auto at(size_type) const -> double;
+		auto at(size_type) -> double&;
+		[[nodiscard]] auto dimensions() const noexcept -> size_type;
+
+		// File-backed vectors keep their magnitudes in a shared mapping of `path`, so writes go
+		// straight to the file. dot, euclidean_norm and the compound operators stream over the
+		// mapping in fixed-size chunks, keeping resident memory bounded. Copies are heap-backed.
+		static auto map_file(std::string const& path) -> euclidean_vector;
+		static auto create_file(std::string const& path, size_type dimensions, double magnitude = 0.0)
+		   -> euclidean_vector;
+		[[nodiscard]] auto is_file_backed() const noexcept -> bool;
+
+		// A content hash over the exact magnitudes, cached until the vector is next modified.
+		// Vectors that are only equal within operator=='s tolerance may hash differently, so hash
+		// containers keyed on euclidean_vector must compare keys with exact_equal, not operator==.
+		[[nodiscard]] auto hash() const noexcept -> std::size_t;
+
+		template<typename H>
+		// NOLINTNEXTLINE(readability-identifier-naming)
+		friend auto AbslHashValue(H h, euclidean_vector const& v) -> H {
+			return H::combine(std::move(h), v.hash());
 		}
 
+		// Magnitudes are compared within std::numeric_limits<double>::epsilon() of each other.
+		friend auto operator==(euclidean_vector const& a, euclidean_vector const& b) -> bool;
+
 		friend auto operator!=(euclidean_vector const& a, euclidean_vector const& b) -> bool {
 			return !(a == b);
 		}
@@ -123,37 +173,81 @@ namespace comp6771 {
 			std::for_each (v.span_.begin(), v.span_.end() - 1, [&os](double const x) { os << x << " "; });
 
 			auto const tail = gsl_lite::narrow_cast<std::vector<double>::size_type>(v.dimensions() - 1);
-			os << v.magnitudes_[tail] << "]";
+			os << v.span_[tail] << "]";
 			return os;
 		}
 
 		friend auto inner_norm(euclidean_vector const& v) -> double {
 			if (v.cache_ >= 0) {
+				detail::record(detail::stat::norm_cache_hit);
 				return v.cache_;
 			}
-			auto res = sqrt(std::inner_product(v.span_.begin(), v.span_.end(), v.span_.begin(), 0.0));
+			detail::record(detail::stat::norm_cache_miss);
+			auto res = std::sqrt(inner_product(v, v));
 			v.cache_ = res;
 			return res;
 		}
 
 		friend auto inner_dot(euclidean_vector const& x, euclidean_vector const& y) -> double {
-			auto const& span_x = x.span_;
-			auto const& span_y = y.span_;
-
-			return std::inner_product(span_x.begin(), span_x.end(), span_y.begin(), 0.0);
+			return inner_product(x, y);
 		}
 
 	private:
-		int dimensions_;
+		friend class euclidean_vector_view;
+		class mapped_file;
+
+		size_type dimensions_;
 		// NOLINTNEXTLINE
 		std::unique_ptr<double[]> magnitudes_;
+		std::unique_ptr<mapped_file> mapping_;
 		auto swap(euclidean_vector& a) -> void;
 		std::span<double> span_;
 		mutable double cache_;
+		mutable std::optional<std::size_t> hash_cache_ = std::nullopt;
+
+		static auto inner_product(euclidean_vector const& x, euclidean_vector const& y) -> double;
+		static auto mapped_spans(euclidean_vector const& x, euclidean_vector const& y) noexcept
+		   -> std::array<std::span<double>, 2>;
 	};
 
 	auto euclidean_norm(euclidean_vector const& v) -> double;
 	auto unit(euclidean_vector const& v) -> euclidean_vector;
 	auto dot(euclidean_vector const& x, euclidean_vector const& y) -> double;
+
+	// A read-only window onto magnitudes owned elsewhere, such as a vector_store segment. Nothing
+	// is copied, and any euclidean_vector converts to one implicitly.
+	class euclidean_vector_view {
+	public:
+		using size_type = euclidean_vector::size_type;
+
+		euclidean_vector_view() noexcept = default;
+		explicit euclidean_vector_view(std::span<double const> magnitudes) noexcept;
+		// NOLINTNEXTLINE(google-explicit-constructor)
+		euclidean_vector_view(euclidean_vector const& v) noexcept;
+		auto operator[](size_type i) const noexcept -> double;
+		[[nodiscard]] auto at(size_type) const -> double;
+		[[nodiscard]] auto dimensions() const noexcept -> size_type;
+		[[nodiscard]] auto magnitudes() const noexcept -> std::span<double const>;
+
+	private:
+		std::span<double const> magnitudes_;
+	};
+
+	auto euclidean_norm(euclidean_vector_view v) -> double;
+	auto dot(euclidean_vector_view x, euclidean_vector_view y) -> double;
+
+	// The key equality that goes with euclidean_vector::hash(): magnitudes must match bit for bit,
+	// except that -0.0 equals +0.0. For example,
+	//    absl::flat_hash_map<euclidean_vector, double, absl::Hash<euclidean_vector>, exact_equal>
+	struct exact_equal {
+		auto operator()(euclidean_vector_view a, euclidean_vector_view b) const noexcept -> bool;
+	};
 } // namespace comp6771
+
+template<>
+struct std::hash<comp6771::euclidean_vector> {
+	auto operator()(comp6771::euclidean_vector const& v) const noexcept -> std::size_t {
+		return v.hash();
+	}
+};
 #endif // COMP6771_EUCLIDEAN_VECTOR_HPP
@@ -0,0 +1,112 @@
+#ifndef COMP6771_VECTOR_STORE_HPP
+#define COMP6771_VECTOR_STORE_HPP
+
+#include "comp6771/euclidean_vector.hpp"
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace comp6771 {
+	class vector_store_error : public std::runtime_error {
+	public:
+		explicit vector_store_error(std::string const& what) noexcept
+		: std::runtime_error(what) {}
+	};
+
+	struct search_result {
+		euclidean_vector::size_type index;
+		double score;
+	};
+
+	// A fixed-size corpus of equally sized vectors in a named POSIX shared-memory segment. One
+	// loader process creates and fills the store, then publishes it. Any number of processes may
+	// then attach read-only and get zero-copy views of its vectors.
+	class vector_store {
+	public:
+		using size_type = euclidean_vector::size_type;
+
+		static auto create(std::string const& name, size_type size, size_type dimensions)
+		   -> vector_store;
+		static auto attach(std::string const& name) -> vector_store;
+		static auto remove(std::string const& name) -> void;
+
+		vector_store(vector_store const&) = delete;
+		vector_store(vector_store&& other) noexcept;
+		~vector_store();
+		auto operator=(vector_store const&) -> vector_store& = delete;
+		auto operator=(vector_store&& other) noexcept -> vector_store&;
+
+		auto assign(size_type i, euclidean_vector_view v) -> void;
+		// Makes the contents visible to attach(). The store is read-only from then on.
+		auto publish() -> void;
+
+		auto operator[](size_type i) const noexcept -> euclidean_vector_view;
+		[[nodiscard]] auto at(size_type i) const -> euclidean_vector_view;
+		[[nodiscard]] auto size() const noexcept -> size_type;
+		[[nodiscard]] auto dimensions() const noexcept -> size_type;
+		[[nodiscard]] auto writable() const noexcept -> bool;
+
+		// The k vectors in [first, last) with the largest dot product against query, best first.
+		[[nodiscard]] auto top_k(euclidean_vector_view query,
+		                         size_type k,
+		                         size_type first,
+		                         size_type last) const -> std::vector<search_result>;
+		[[nodiscard]] auto top_k(euclidean_vector_view query, size_type k) const
+		   -> std::vector<search_result>;
+
+	private:
+		struct header;
+
+		vector_store(void* address, std::size_t bytes, bool writable) noexcept;
+		[[nodiscard]] auto data() const noexcept -> double*;
+		[[nodiscard]] auto info() const noexcept -> header const&;
+
+		void* address_;
+		std::size_t bytes_;
+		bool writable_;
+	};
+
+	// Forks `workers` processes that each attach to the named store and own a contiguous shard
+	// of it. A query goes to every worker over a socket, and their partial top-k lists are merged.
+	// The pool is move-only. Destroying it shuts the workers down and reaps them.
+	class shard_pool {
+	public:
+		using size_type = vector_store::size_type;
+
+		shard_pool(std::string const& name, int workers);
+		shard_pool(shard_pool const&) = delete;
+		shard_pool(shard_pool&& other) noexcept;
+		~shard_pool();
+		auto operator=(shard_pool const&) -> shard_pool& = delete;
+		auto operator=(shard_pool&&) -> shard_pool& = delete;
+
+		// Safe to call from several threads, but calls take turns: each one talks to every
+		// worker over the same sockets. If any worker fails mid-query, the others may be left with
+		// the query or its replies, so the pool shuts every worker down and this and every later
+		// call throws.
+		[[nodiscard]] auto top_k(euclidean_vector_view query, size_type k) const
+		   -> std::vector<search_result>;
+		[[nodiscard]] auto workers() const noexcept -> int;
+
+	private:
+		struct worker {
+			pid_t pid;
+			int socket;
+		};
+
+		auto spawn(std::string const& name, size_type size, int workers) -> void;
+		// Closes every worker's socket and reaps it.
+		auto shutdown() const noexcept -> void;
+
+		size_type dimensions_;
+		// Mutable so that top_k can shut down a pool whose protocol has broken.
+		mutable std::vector<worker> workers_;
+		mutable bool broken_ = false;
+		mutable std::mutex mutex_;
+	};
+} // namespace comp6771
+#endif // COMP6771_VECTOR_STORE_HPP
@@ -0,0 +1,238 @@
+#include "comp6771/batch_scorer.hpp"
+
+#include "comp6771/euclidean_vector.hpp"
+#include "gsl-lite/gsl-lite.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fmt/format.h>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	auto latency_histogram::record(std::chrono::nanoseconds latency) noexcept -> void {
+		auto const value = static_cast<std::uint64_t>(std::max(latency.count(), std::int64_t{0}));
+		auto index = value;
+		if (value >= sub_buckets) {
+			auto const exponent = static_cast<std::uint64_t>(std::bit_width(value)) - 5;
+			index = sub_buckets * (exponent + 1) + ((value >> exponent) - sub_buckets);
+		}
+		++counts_[static_cast<std::size_t>(index)];
+		++count_;
+	}
+
+	auto latency_histogram::merge(latency_histogram const& other) noexcept -> void {
+		std::transform(counts_.begin(),
+		               counts_.end(),
+		               other.counts_.begin(),
+		               counts_.begin(),
+		               std::plus<>());
+		count_ += other.count_;
+	}
+
+	auto latency_histogram::count() const noexcept -> std::uint64_t {
+		return count_;
+	}
+
+	auto latency_histogram::percentile(double p) const noexcept -> std::chrono::nanoseconds {
+		if (count_ == 0) {
+			return std::chrono::nanoseconds(0);
+		}
+		auto const rank = static_cast<std::uint64_t>(
+		   std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(count_)));
+		auto seen = std::uint64_t{0};
+		for (auto index = std::size_t{0}; index < bucket_count; ++index) {
+			seen += counts_[index];
+			if (seen >= std::max(rank, std::uint64_t{1})) {
+				if (index < sub_buckets) {
+					return std::chrono::nanoseconds(index);
+				}
+				auto const exponent = index / sub_buckets - 1;
+				auto const upper = ((index % sub_buckets + sub_buckets + 1) << exponent) - 1;
+				return std::chrono::nanoseconds(static_cast<std::int64_t>(upper));
+			}
+		}
+		return std::chrono::nanoseconds::max();
+	}
+
+	struct batch_scorer::state {
+		std::vector<euclidean_vector> model;
+		options opts;
+
+		mutable std::mutex mutex;
+		std::condition_variable batcher_wakeup;
+		std::condition_variable pool_wakeup;
+		std::deque<request*> pending;
+		std::deque<std::vector<request*>> ready;
+		std::size_t in_flight = 0;
+		bool stopping = false;
+		bool drained = false;
+
+		latency_histogram latencies;
+		std::uint64_t batches = 0;
+
+		std::vector<std::jthread> pool;
+		std::jthread batcher;
+
+		auto run_batcher() -> void;
+		auto run_worker() -> void;
+		auto score(std::vector<request*> const& batch) const -> void;
+	};
+
+	auto batch_scorer::state::run_batcher() -> void {
+		auto lock = std::unique_lock(mutex);
+		while (true) {
+			// Batches still being scored can resume coroutines that submit more queries, so
+			// shutdown waits for them as well as for the pending queue.
+			batcher_wakeup.wait(lock, [this] {
+				return not pending.empty() or (stopping and ready.empty() and in_flight == 0);
+			});
+			if (pending.empty()) {
+				break;
+			}
+			auto const deadline = pending.front()->enqueued + opts.deadline;
+			batcher_wakeup.wait_until(lock, deadline, [this] {
+				return stopping or pending.size() >= opts.max_batch;
+			});
+
+			auto const last = pending.begin()
+			                  + static_cast<std::ptrdiff_t>(std::min(pending.size(), opts.max_batch));
+			auto batch = std::vector<request*>(pending.begin(), last);
+			pending.erase(pending.begin(), last);
+			ready.push_back(std::move(batch));
+			++batches;
+			pool_wakeup.notify_one();
+		}
+		drained = true;
+		pool_wakeup.notify_all();
+	}
+
+	auto batch_scorer::state::run_worker() -> void {
+		auto lock = std::unique_lock(mutex);
+		while (true) {
+			pool_wakeup.wait(lock, [this] { return drained or not ready.empty(); });
+			if (ready.empty()) {
+				return;
+			}
+			auto batch = std::move(ready.front());
+			ready.pop_front();
+			++in_flight;
+
+			lock.unlock();
+			score(batch);
+			auto const done = std::chrono::steady_clock::now();
+			lock.lock();
+			for (auto const* r : batch) {
+				latencies.record(done - r->enqueued);
+			}
+
+			// A resumed coroutine may call score() again, which needs the lock.
+			lock.unlock();
+			for (auto* r : batch) {
+				r->waiter.resume();
+			}
+			lock.lock();
+			--in_flight;
+			batcher_wakeup.notify_one();
+		}
+	}
+
+	// Model vectors are the outer loop so each one is read from memory once per batch and then
+	// reused from cache for every query in it.
+	auto batch_scorer::state::score(std::vector<request*> const& batch) const -> void {
+		for (auto* r : batch) {
+			r->result.dots.resize(model.size());
+			r->result.norm = euclidean_norm(euclidean_vector_view(r->query));
+		}
+		for (auto m = std::size_t{0}; m < model.size(); ++m) {
+			auto const row = euclidean_vector_view(model[m]).magnitudes();
+			for (auto* r : batch) {
+				auto const query = euclidean_vector_view(r->query).magnitudes();
+				r->result.dots[m] = std::inner_product(row.begin(), row.end(), query.begin(), 0.0);
+			}
+		}
+	}
+
+	batch_scorer::batch_scorer(std::vector<euclidean_vector> model)
+	: batch_scorer(std::move(model), options{}) {}
+
+	batch_scorer::batch_scorer(std::vector<euclidean_vector> model, options opts)
+	: state_{std::make_unique<state>()} {
+		if (not model.empty()) {
+			auto const dimensions = model.front().dimensions();
+			auto const mismatch =
+			   std::find_if(model.begin(), model.end(), [dimensions](euclidean_vector const& v) {
+				   return v.dimensions() != dimensions;
+			   });
+			if (mismatch != model.end()) {
+				throw euclidean_vector_error(fmt::format("Dimensions of LHS({}) and RHS({}) do not "
+				                                         "match",
+				                                         dimensions,
+				                                         mismatch->dimensions()));
+			}
+		}
+		opts.max_batch = std::max(opts.max_batch, std::size_t{1});
+		opts.threads = std::max(opts.threads, 1U);
+		state_->model = std::move(model);
+		state_->opts = opts;
+
+		for (auto i = 0U; i < opts.threads; ++i) {
+			state_->pool.emplace_back([s = state_.get()] { s->run_worker(); });
+		}
+		state_->batcher = std::jthread([s = state_.get()] { s->run_batcher(); });
+	}
+
+	batch_scorer::~batch_scorer() {
+		{
+			auto const lock = std::scoped_lock(state_->mutex);
+			state_->stopping = true;
+		}
+		state_->batcher_wakeup.notify_all();
+		state_->batcher.join();
+		for (auto& worker : state_->pool) {
+			worker.join();
+		}
+	}
+
+	auto batch_scorer::score(euclidean_vector query) -> awaitable {
+		// Checked here because a pool thread has nowhere to throw euclidean_norm's error to.
+		if (query.dimensions() == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a "
+			                             "norm");
+		}
+		if (not state_->model.empty() and query.dimensions() != state_->model.front().dimensions()) {
+			throw euclidean_vector_error(fmt::format("Dimensions of LHS({}) and RHS({}) do not match",
+			                                         query.dimensions(),
+			                                         state_->model.front().dimensions()));
+		}
+		return awaitable(*this, std::move(query));
+	}
+
+	auto batch_scorer::enqueue(request& r) -> void {
+		{
+			auto const lock = std::scoped_lock(state_->mutex);
+			r.enqueued = std::chrono::steady_clock::now();
+			state_->pending.push_back(&r);
+		}
+		state_->batcher_wakeup.notify_one();
+	}
+
+	auto batch_scorer::latencies() const -> latency_histogram {
+		auto const lock = std::scoped_lock(state_->mutex);
+		return state_->latencies;
+	}
+
+	auto batch_scorer::batches() const -> std::uint64_t {
+		auto const lock = std::scoped_lock(state_->mutex);
+		return state_->batches;
+	}
+} // namespace comp6771
@@ -4,27 +4,228 @@
 #include "comp6771/euclidean_vector.hpp"
 #include "gsl-lite/gsl-lite.hpp"
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <bits/types/FILE.h>
+#include <cerrno>
 #include <cstddef>
+#include <cstring>
+#include <fcntl.h>
 #include <fmt/format.h>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <optional>
 #include <span>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <utility>
 #include <vector>
 
 namespace comp6771 {
+	class euclidean_vector::mapped_file {
+	public:
+		mapped_file(void* address, std::size_t bytes) noexcept
+		: address_{address}
+		, bytes_{bytes} {}
+		mapped_file(mapped_file const&) = delete;
+		mapped_file(mapped_file&&) = delete;
+		auto operator=(mapped_file const&) -> mapped_file& = delete;
+		auto operator=(mapped_file&&) -> mapped_file& = delete;
+		~mapped_file() {
+			::munmap(address_, bytes_);
+		}
+
+		[[nodiscard]] auto data() const noexcept -> double* {
+			return static_cast<double*>(address_);
+		}
+
+	private:
+		void* address_;
+		std::size_t bytes_;
+	};
+
+	namespace {
+		// 8 MiB worth of magnitudes, which is a multiple of the page size on every platform we
+		// build for, so chunk boundaries inside a mapping are always page aligned.
+		constexpr auto chunk_size = std::size_t{1} << 20;
+
+		auto file_error(std::string_view action, std::string const& path) -> euclidean_vector_error {
+			return euclidean_vector_error(
+			   fmt::format("Cannot {} {}: {}", action, path, std::strerror(errno)));
+		}
+
+		auto advise(std::span<double> pages, int advice) noexcept -> void {
+			if (not pages.empty()) {
+				::madvise(pages.data(), pages.size_bytes(), advice);
+			}
+		}
+
+		// Calls f(offset, count) over consecutive chunks of [0, size). Each span in `mapped` has
+		// its next chunk prefetched before f runs and its current chunk released afterwards.
+		template<typename F>
+		auto for_each_chunk(std::size_t size, std::array<std::span<double>, 2> const& mapped, F f)
+		   -> void {
+			for (auto offset = std::size_t{0}; offset < size; offset += chunk_size) {
+				auto const count = std::min(chunk_size, size - offset);
+				auto const next = offset + count;
+				for (auto const& pages : mapped) {
+					if (not pages.empty()) {
+						advise(pages.subspan(next, std::min(chunk_size, size - next)), MADV_WILLNEED);
+					}
+				}
+				f(offset, count);
+				for (auto const& pages : mapped) {
+					if (not pages.empty()) {
+						advise(pages.subspan(offset, count), MADV_DONTNEED);
+					}
+				}
+			}
+		}
+
+		// splitmix64's finaliser.
+		constexpr auto mix(std::uint64_t x) noexcept -> std::uint64_t {
+			x = (x ^ (x >> 30U)) * 0xbf58476d1ce4e5b9U;
+			x = (x ^ (x >> 27U)) * 0x94d049bb133111ebU;
+			return x ^ (x >> 31U);
+		}
+
+		// Compares a block of magnitudes without branching, so the loop vectorises and only the
+		// block boundary needs a test. NaNs compare unequal, as they did element by element.
+		constexpr auto equality_block = std::size_t{8};
+
+		auto within_tolerance(double const* a, double const* b, std::size_t count) noexcept -> bool {
+			auto mismatches = 0.0;
+			for (auto i = std::size_t{0}; i < count; ++i) {
+				mismatches +=
+				   std::fabs(a[i] - b[i]) <= std::numeric_limits<double>::epsilon() ? 0.0 : 1.0;
+			}
+			return mismatches == 0.0;
+		}
+
+		// Bit patterns with -0.0 taken as +0.0, the same normalisation hash() applies.
+		auto same_bits(double const* a, double const* b, std::size_t count) noexcept -> bool {
+			auto mismatches = std::uint64_t{0};
+			for (auto i = std::size_t{0}; i < count; ++i) {
+				auto const x = std::bit_cast<std::uint64_t>(a[i] == 0.0 ? 0.0 : a[i]);
+				auto const y = std::bit_cast<std::uint64_t>(b[i] == 0.0 ? 0.0 : b[i]);
+				mismatches |= x ^ y;
+			}
+			return mismatches == 0;
+		}
+
+		auto map_descriptor(int fd, std::string const& path, std::size_t bytes) -> void* {
+			auto* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			auto const saved_errno = errno;
+			::close(fd);
+			if (address == MAP_FAILED) {
+				errno = saved_errno;
+				throw file_error("map", path);
+			}
+			::madvise(address, bytes, MADV_SEQUENTIAL);
+			return address;
+		}
+	} // namespace
+
+#if COMP6771_EUCLIDEAN_VECTOR_STATS
+	namespace {
+		constexpr auto stat_count = std::size_t{5};
+		using stat_totals = std::array<std::uint64_t, stat_count>;
+
+		// Each thread bumps its own counters without contention. They are atomics only so that a
+		// snapshot taken on another thread can read them; the owner never needs a locked RMW.
+		struct thread_stats {
+			thread_stats();
+			thread_stats(thread_stats const&) = delete;
+			thread_stats(thread_stats&&) = delete;
+			auto operator=(thread_stats const&) -> thread_stats& = delete;
+			auto operator=(thread_stats&&) -> thread_stats& = delete;
+			~thread_stats();
+
+			std::array<std::atomic<std::uint64_t>, stat_count> values = {};
+		};
+
+		struct stats_registry {
+			std::mutex mutex;
+			std::vector<thread_stats*> live;
+			stat_totals retired = {};
+			stat_totals baseline = {};
+
+			auto totals() -> stat_totals {
+				auto result = retired;
+				for (auto const* t : live) {
+					for (auto i = std::size_t{0}; i < stat_count; ++i) {
+						result[i] += t->values[i].load(std::memory_order_relaxed);
+					}
+				}
+				return result;
+			}
+		};
+
+		auto registry() -> stats_registry& {
+			static auto instance = stats_registry();
+			return instance;
+		}
+
+		thread_stats::thread_stats() {
+			auto& r = registry();
+			auto const lock = std::scoped_lock(r.mutex);
+			r.live.push_back(this);
+		}
+
+		thread_stats::~thread_stats() {
+			auto& r = registry();
+			auto const lock = std::scoped_lock(r.mutex);
+			for (auto i = std::size_t{0}; i < stat_count; ++i) {
+				r.retired[i] += values[i].load(std::memory_order_relaxed);
+			}
+			std::erase(r.live, this);
+		}
+	} // namespace
+
+	auto detail::record(stat s) noexcept -> void {
+		thread_local auto local = thread_stats();
+		auto& value = local.values[static_cast<std::size_t>(s)];
+		value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	auto stats_snapshot() -> euclidean_vector_stats {
+		auto& r = registry();
+		auto const lock = std::scoped_lock(r.mutex);
+		auto totals = r.totals();
+		for (auto i = std::size_t{0}; i < stat_count; ++i) {
+			totals[i] -= r.baseline[i];
+		}
+		return euclidean_vector_stats{totals[0], totals[1], totals[2], totals[3], totals[4]};
+	}
+
+	auto reset_stats() -> void {
+		auto& r = registry();
+		auto const lock = std::scoped_lock(r.mutex);
+		r.baseline = r.totals();
+	}
+#else
+	auto stats_snapshot() -> euclidean_vector_stats {
+		return euclidean_vector_stats{};
+	}
+
+	auto reset_stats() -> void {}
+#endif
 
 	euclidean_vector::euclidean_vector()
 	: euclidean_vector(1, 0.0) {}
-	euclidean_vector::euclidean_vector(int dimensions)
+	euclidean_vector::euclidean_vector(size_type dimensions)
 	: euclidean_vector(dimensions, 0.0) {}
 
-	euclidean_vector::euclidean_vector(int dimensions, double magnitude)
+	euclidean_vector::euclidean_vector(size_type dimensions, double magnitude)
 	: dimensions_{dimensions}
 	, cache_{-1} {
 		if (dimensions_ == 0) {
@@ -34,6 +235,7 @@ namespace comp6771 {
 			auto size = gsl_lite::narrow_cast<std::vector<double>::size_type>(dimensions);
 			// NOLINTNEXTLINE(modernize-avoid-c-arrays)
 			magnitudes_ = std::make_unique<double[]>(size);
+			detail::record(detail::stat::allocation);
 			span_ = std::span<double>(magnitudes_.get(), size);
 			std::fill(span_.begin(), span_.end(), magnitude);
 		}
@@ -42,7 +244,7 @@ namespace comp6771 {
 	euclidean_vector::euclidean_vector(std::vector<double>::const_iterator start,
 	                                   std::vector<double>::const_iterator end)
 	: cache_{-1} {
-		dimensions_ = gsl_lite::narrow_cast<int>(ranges::distance(start, end));
+		dimensions_ = ranges::distance(start, end);
 
 		if (dimensions_ == 0) {
 			magnitudes_ = nullptr;
@@ -51,6 +253,7 @@ namespace comp6771 {
 			auto const size = gsl_lite::narrow_cast<std::vector<double>::size_type>(dimensions_);
 			// NOLINTNEXTLINE(modernize-avoid-c-arrays)
 			magnitudes_ = std::make_unique<double[]>(size);
+			detail::record(detail::stat::allocation);
 			span_ = std::span<double>(magnitudes_.get(), size);
 			std::transform(start, end, span_.begin(), [](double x) -> double { return x; });
 		}
@@ -58,6 +261,7 @@ namespace comp6771 {
 	euclidean_vector::euclidean_vector(euclidean_vector const& a)
 	: dimensions_{a.dimensions_}
 	, cache_{-1} {
+		detail::record(detail::stat::copy);
 		if (dimensions_ == 0) {
 			magnitudes_ = nullptr;
 		}
@@ -65,6 +269,7 @@ namespace comp6771 {
 			auto const size = gsl_lite::narrow_cast<std::vector<double>::size_type>(dimensions_);
 			// NOLINTNEXTLINE(modernize-avoid-c-arrays)
 			magnitudes_ = std::make_unique<double[]>(size);
+			detail::record(detail::stat::allocation);
 			span_ = std::span<double>(magnitudes_.get(), size);
 			std::transform(a.span_.begin(), a.span_.end(), span_.begin(), [](double x) -> double {
 				return x;
@@ -73,7 +278,7 @@ namespace comp6771 {
 	}
 
 	euclidean_vector::euclidean_vector(std::initializer_list<double> list)
-	: dimensions_{gsl_lite::narrow_cast<int>(ranges::distance(list))}
+	: dimensions_{ranges::distance(list)}
 	, cache_{-1} {
 		if (dimensions_ == 0) {
 			magnitudes_ = nullptr;
@@ -82,6 +287,7 @@ namespace comp6771 {
 			auto const size = gsl_lite::narrow_cast<std::vector<double>::size_type>(dimensions_);
 			// NOLINTNEXTLINE(modernize-avoid-c-arrays)
 			magnitudes_ = std::make_unique<double[]>(size);
+			detail::record(detail::stat::allocation);
 			span_ = std::span<double>(magnitudes_.get(), size);
 			std::transform(list.begin(), list.end(), span_.begin(), [](double x) -> double { return x; });
 		}
@@ -90,8 +296,14 @@ namespace comp6771 {
 	euclidean_vector::euclidean_vector(euclidean_vector&& a) noexcept
 	: dimensions_{std::exchange(a.dimensions_, 0)}
 	, magnitudes_{std::exchange(a.magnitudes_, nullptr)}
+	, mapping_{std::exchange(a.mapping_, nullptr)}
 	, span_{std::exchange(a.span_, std::span<double>())}
-	, cache_{std::exchange(a.cache_, -1)} {}
+	, cache_{std::exchange(a.cache_, -1)}
+	, hash_cache_{std::exchange(a.hash_cache_, std::nullopt)} {
+		detail::record(detail::stat::move);
+	}
+
+	euclidean_vector::~euclidean_vector() = default;
 
 	auto euclidean_vector::operator=(euclidean_vector const& a) -> euclidean_vector& {
 		auto copy = euclidean_vector(a);
@@ -100,29 +312,35 @@ namespace comp6771 {
 	}
 
 	auto euclidean_vector::operator=(euclidean_vector&& ori) noexcept -> euclidean_vector& {
+		detail::record(detail::stat::move);
 		dimensions_ = std::exchange(ori.dimensions_, 0);
 		magnitudes_ = std::exchange(ori.magnitudes_, nullptr);
+		mapping_ = std::exchange(ori.mapping_, nullptr);
 		span_ = std::exchange(ori.span_, std::span<double>());
 		cache_ = std::exchange(ori.cache_, -1);
+		hash_cache_ = std::exchange(ori.hash_cache_, std::nullopt);
 		return *this;
 	}
 
 	auto euclidean_vector::swap(euclidean_vector& a) -> void {
 		std::swap(dimensions_, a.dimensions_);
 		std::swap(magnitudes_, a.magnitudes_);
+		std::swap(mapping_, a.mapping_);
 		std::swap(span_, a.span_);
 		std::swap(cache_, a.cache_);
+		std::swap(hash_cache_, a.hash_cache_);
 	}
 
-	auto euclidean_vector::operator[](int i) noexcept -> double& {
+	auto euclidean_vector::operator[](size_type i) noexcept -> double& {
 		assert(i < dimensions_);
 		cache_ = -1;
-		return magnitudes_[gsl_lite::narrow_cast<std::size_t>(i)];
+		hash_cache_.reset();
+		return span_[gsl_lite::narrow_cast<std::size_t>(i)];
 	}
 
-	auto euclidean_vector::operator[](int i) const noexcept -> double {
+	auto euclidean_vector::operator[](size_type i) const noexcept -> double {
 		assert(i < dimensions_);
-		return magnitudes_[gsl_lite::narrow_cast<std::size_t>(i)];
+		return span_[gsl_lite::narrow_cast<std::size_t>(i)];
 	}
 
 	auto euclidean_vector::operator+() const -> euclidean_vector {
@@ -143,7 +361,12 @@ namespace comp6771 {
 			                                         other.dimensions_));
 		}
 		cache_ = -1;
-		std::transform(span_.begin(), span_.end(), other.span_.begin(), span_.begin(), std::plus<>());
+		hash_cache_.reset();
+		for_each_chunk(span_.size(), mapped_spans(*this, other), [&](auto offset, auto count) {
+			auto lhs = span_.subspan(offset, count);
+			auto rhs = other.span_.subspan(offset, count);
+			std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(), std::plus<>());
+		});
 		return *this;
 	}
 
@@ -154,15 +377,24 @@ namespace comp6771 {
 			                                         other.dimensions_));
 		}
 		cache_ = -1;
-		std::transform(span_.begin(), span_.end(), other.span_.begin(), span_.begin(), std::minus<>());
+		hash_cache_.reset();
+		for_each_chunk(span_.size(), mapped_spans(*this, other), [&](auto offset, auto count) {
+			auto lhs = span_.subspan(offset, count);
+			auto rhs = other.span_.subspan(offset, count);
+			std::transform(lhs.begin(), lhs.end(), rhs.begin(), lhs.begin(), std::minus<>());
+		});
 		return *this;
 	}
 
 	auto euclidean_vector::operator*=(double d) noexcept -> euclidean_vector& {
-		std::transform(span_.begin(), span_.end(), span_.begin(), [d](double x) -> double {
-			return x * d;
+		for_each_chunk(span_.size(), mapped_spans(*this, *this), [&](auto offset, auto count) {
+			auto lhs = span_.subspan(offset, count);
+			std::transform(lhs.begin(), lhs.end(), lhs.begin(), [d](double x) -> double {
+				return x * d;
+			});
 		});
 		cache_ = -1;
+		hash_cache_.reset();
 		return *this;
 	}
 
@@ -170,10 +402,14 @@ namespace comp6771 {
 		if (d == 0) {
 			throw euclidean_vector_error("Invalid vector division by 0");
 		}
-		std::transform(span_.begin(), span_.end(), span_.begin(), [d](double x) -> double {
-			return x / d;
+		for_each_chunk(span_.size(), mapped_spans(*this, *this), [&](auto offset, auto count) {
+			auto lhs = span_.subspan(offset, count);
+			std::transform(lhs.begin(), lhs.end(), lhs.begin(), [d](double x) -> double {
+				return x / d;
+			});
 		});
 		cache_ = -1;
+		hash_cache_.reset();
 		return *this;
 	}
 
@@ -193,27 +429,164 @@ namespace comp6771 {
 		return result;
 	}
 
-	auto euclidean_vector::at(int i) const -> double {
+	auto euclidean_vector::at(size_type i) const -> double {
 		if (i < 0 or i >= dimensions_) {
 			throw euclidean_vector_error(
 			   fmt::format("Index {} is not valid for this euclidean_vector object", i));
 		}
-		return this->magnitudes_[gsl_lite::narrow_cast<std::size_t>(i)];
+		return this->span_[gsl_lite::narrow_cast<std::size_t>(i)];
 	}
 
-	auto euclidean_vector::at(int i) -> double& {
+	auto euclidean_vector::at(size_type i) -> double& {
 		if (i < 0 or i >= dimensions_) {
 			throw euclidean_vector_error(
 			   fmt::format("Index {} is not valid for this euclidean_vector object", i));
 		}
 		cache_ = -1;
-		return magnitudes_[gsl_lite::narrow_cast<std::size_t>(i)];
+		hash_cache_.reset();
+		return span_[gsl_lite::narrow_cast<std::size_t>(i)];
 	}
 
-	auto euclidean_vector::dimensions() const noexcept -> int {
+	auto euclidean_vector::dimensions() const noexcept -> size_type {
 		return dimensions_;
 	}
 
+	auto euclidean_vector::hash() const noexcept -> std::size_t {
+		if (hash_cache_) {
+			return *hash_cache_;
+		}
+		// Four independent lanes keep the mixing off a single dependency chain. Zero is hashed
+		// as +0.0 because operator== treats the two signed zeros as equal.
+		auto lanes = std::array<std::uint64_t, 4>{0, 1, 2, 3};
+		auto const size = span_.size();
+		for (auto i = std::size_t{0}; i < size; ++i) {
+			auto const magnitude = span_[i] == 0.0 ? 0.0 : span_[i];
+			auto& lane = lanes[i % lanes.size()];
+			lane = mix(lane ^ std::bit_cast<std::uint64_t>(magnitude));
+		}
+		auto result = mix(static_cast<std::uint64_t>(size));
+		for (auto const lane : lanes) {
+			result = mix(result ^ lane);
+		}
+		hash_cache_ = static_cast<std::size_t>(result);
+		return *hash_cache_;
+	}
+
+	auto euclidean_vector::map_file(std::string const& path) -> euclidean_vector {
+		auto const fd = ::open(path.c_str(), O_RDWR);
+		if (fd == -1) {
+			throw file_error("open", path);
+		}
+		struct stat info = {};
+		if (::fstat(fd, &info) == -1) {
+			auto const error = file_error("stat", path);
+			::close(fd);
+			throw error;
+		}
+		auto const bytes = gsl_lite::narrow_cast<std::size_t>(info.st_size);
+		if (bytes % sizeof(double) != 0) {
+			::close(fd);
+			throw euclidean_vector_error(
+			   fmt::format("{} does not hold a whole number of magnitudes", path));
+		}
+
+		auto result = euclidean_vector(0);
+		if (bytes == 0) {
+			::close(fd);
+			return result;
+		}
+		auto* address = map_descriptor(fd, path, bytes);
+		result.mapping_ = std::make_unique<mapped_file>(address, bytes);
+		result.dimensions_ = gsl_lite::narrow_cast<size_type>(bytes / sizeof(double));
+		result.span_ = std::span<double>(result.mapping_->data(), bytes / sizeof(double));
+		return result;
+	}
+
+	auto euclidean_vector::create_file(std::string const& path,
+	                                   size_type dimensions,
+	                                   double magnitude) -> euclidean_vector {
+		// Checked before opening, since O_TRUNC would already have emptied an existing file.
+		if (dimensions < 0
+		    or dimensions > std::numeric_limits<off_t>::max() / static_cast<off_t>(sizeof(double))) {
+			throw euclidean_vector_error(
+			   fmt::format("Cannot create a file-backed euclidean_vector with {} dimensions",
+			               dimensions));
+		}
+		auto const fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (fd == -1) {
+			throw file_error("create", path);
+		}
+		auto const size = gsl_lite::narrow_cast<std::size_t>(dimensions);
+		if (::ftruncate(fd, gsl_lite::narrow_cast<off_t>(size * sizeof(double))) == -1) {
+			auto const error = file_error("resize", path);
+			::close(fd);
+			throw error;
+		}
+
+		auto result = euclidean_vector(0);
+		if (size == 0) {
+			::close(fd);
+			return result;
+		}
+		auto* address = map_descriptor(fd, path, size * sizeof(double));
+		result.mapping_ = std::make_unique<mapped_file>(address, size * sizeof(double));
+		result.dimensions_ = dimensions;
+		result.span_ = std::span<double>(result.mapping_->data(), size);
+		// A freshly truncated file already reads as zeros, so leave it sparse in that case.
+		if (magnitude != 0.0) {
+			for_each_chunk(size, mapped_spans(result, result), [&](auto offset, auto count) {
+				auto chunk = result.span_.subspan(offset, count);
+				std::fill(chunk.begin(), chunk.end(), magnitude);
+			});
+		}
+		return result;
+	}
+
+	auto euclidean_vector::is_file_backed() const noexcept -> bool {
+		return mapping_ != nullptr;
+	}
+
+	auto euclidean_vector::mapped_spans(euclidean_vector const& x,
+	                                    euclidean_vector const& y) noexcept
+	   -> std::array<std::span<double>, 2> {
+		auto result = std::array<std::span<double>, 2>();
+		if (x.mapping_ != nullptr) {
+			result[0] = x.span_;
+		}
+		if (y.mapping_ != nullptr and y.mapping_ != x.mapping_) {
+			result[1] = y.span_;
+		}
+		return result;
+	}
+
+	auto euclidean_vector::inner_product(euclidean_vector const& x, euclidean_vector const& y)
+	   -> double {
+		auto result = 0.0;
+		for_each_chunk(x.span_.size(), mapped_spans(x, y), [&](auto offset, auto count) {
+			auto chunk = x.span_.subspan(offset, count);
+			auto other = y.span_.subspan(offset, count);
+			result = std::inner_product(chunk.begin(), chunk.end(), other.begin(), result);
+		});
+		return result;
+	}
+
+	auto operator==(euclidean_vector const& a, euclidean_vector const& b) -> bool {
+		if (a.dimensions() != b.dimensions()) {
+			return false;
+		}
+
+		auto const size = a.span_.size();
+		auto offset = std::size_t{0};
+		for (; offset + equality_block <= size; offset += equality_block) {
+			auto const* lhs = a.span_.data() + offset;
+			auto const* rhs = b.span_.data() + offset;
+			if (not within_tolerance(lhs, rhs, equality_block)) {
+				return false;
+			}
+		}
+		return within_tolerance(a.span_.data() + offset, b.span_.data() + offset, size - offset);
+	}
+
 	auto euclidean_norm(euclidean_vector const& v) -> double {
 		if (v.dimensions() == 0) {
 			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a "
@@ -245,4 +618,58 @@ namespace comp6771 {
 		}
 		return inner_dot(x, y);
 	}
+
+	euclidean_vector_view::euclidean_vector_view(std::span<double const> magnitudes) noexcept
+	: magnitudes_{magnitudes} {}
+
+	euclidean_vector_view::euclidean_vector_view(euclidean_vector const& v) noexcept
+	: magnitudes_{v.span_} {}
+
+	auto euclidean_vector_view::operator[](size_type i) const noexcept -> double {
+		assert(i < dimensions());
+		return magnitudes_[gsl_lite::narrow_cast<std::size_t>(i)];
+	}
+
+	auto euclidean_vector_view::at(size_type i) const -> double {
+		if (i < 0 or i >= dimensions()) {
+			throw euclidean_vector_error(
+			   fmt::format("Index {} is not valid for this euclidean_vector object", i));
+		}
+		return magnitudes_[gsl_lite::narrow_cast<std::size_t>(i)];
+	}
+
+	auto euclidean_vector_view::dimensions() const noexcept -> size_type {
+		return gsl_lite::narrow_cast<size_type>(magnitudes_.size());
+	}
+
+	auto euclidean_vector_view::magnitudes() const noexcept -> std::span<double const> {
+		return magnitudes_;
+	}
+
+	auto euclidean_norm(euclidean_vector_view v) -> double {
+		if (v.dimensions() == 0) {
+			throw euclidean_vector_error("euclidean_vector with no dimensions does not have a "
+			                             "norm");
+		}
+		auto const m = v.magnitudes();
+		return std::sqrt(std::inner_product(m.begin(), m.end(), m.begin(), 0.0));
+	}
+
+	auto dot(euclidean_vector_view x, euclidean_vector_view y) -> double {
+		if (x.dimensions() != y.dimensions()) {
+			throw euclidean_vector_error(fmt::format("Dimensions of LHS({}) and RHS({}) do not match",
+			                                         x.dimensions(),
+			                                         y.dimensions()));
+		}
+		auto const a = x.magnitudes();
+		auto const b = y.magnitudes();
+		return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+	}
+
+	auto exact_equal::operator()(euclidean_vector_view a, euclidean_vector_view b) const noexcept
+	   -> bool {
+		auto const x = a.magnitudes();
+		auto const y = b.magnitudes();
+		return x.size() == y.size() and same_bits(x.data(), y.data(), x.size());
+	}
 } // namespace comp6771
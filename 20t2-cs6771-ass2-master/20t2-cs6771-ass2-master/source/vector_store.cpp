@@ -0,0 +1,455 @@
+#include "comp6771/vector_store.hpp"
+
+#include "comp6771/euclidean_vector.hpp"
+#include "gsl-lite/gsl-lite.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace comp6771 {
+	struct vector_store::header {
+		std::uint64_t magic;
+		std::int64_t size;
+		std::int64_t dimensions;
+	};
+
+	namespace {
+		// Written last by publish(), so a reader that sees it also sees every magnitude.
+		constexpr auto published = std::uint64_t{0x636f6d7036373731};
+		// Keeps the magnitudes cache-line aligned.
+		constexpr auto data_offset = std::size_t{64};
+
+		auto store_error(std::string_view action, std::string const& name) -> vector_store_error {
+			return vector_store_error(
+			   fmt::format("Cannot {} {}: {}", action, name, std::strerror(errno)));
+		}
+
+		// The segment size for size vectors of the given dimensions, or 0 if either is negative or
+		// the size doesn't fit in an off_t.
+		auto segment_bytes(std::int64_t size, std::int64_t dimensions) noexcept -> std::size_t {
+			constexpr auto max_magnitudes =
+			   (static_cast<std::uint64_t>(std::numeric_limits<off_t>::max()) - data_offset)
+			   / sizeof(double);
+			if (size < 0 or dimensions < 0) {
+				return 0;
+			}
+			auto const s = static_cast<std::uint64_t>(size);
+			auto const d = static_cast<std::uint64_t>(dimensions);
+			if (d != 0 and s > max_magnitudes / d) {
+				return 0;
+			}
+			return data_offset + gsl_lite::narrow_cast<std::size_t>(s * d) * sizeof(double);
+		}
+
+		auto better(search_result const& a, search_result const& b) noexcept -> bool {
+			return a.score > b.score or (a.score == b.score and a.index < b.index);
+		}
+
+		auto read_all(int fd, std::span<std::byte> buffer) -> bool {
+			while (not buffer.empty()) {
+				auto const n = ::read(fd, buffer.data(), buffer.size());
+				if (n == 0) {
+					return false;
+				}
+				if (n == -1) {
+					if (errno == EINTR) {
+						continue;
+					}
+					return false;
+				}
+				buffer = buffer.subspan(static_cast<std::size_t>(n));
+			}
+			return true;
+		}
+
+		auto write_all(int fd, std::span<std::byte const> buffer) -> bool {
+			while (not buffer.empty()) {
+				auto const n = ::send(fd, buffer.data(), buffer.size(), MSG_NOSIGNAL);
+				if (n == -1) {
+					if (errno == EINTR) {
+						continue;
+					}
+					return false;
+				}
+				buffer = buffer.subspan(static_cast<std::size_t>(n));
+			}
+			return true;
+		}
+
+		template<typename T>
+		auto read_value(int fd, T& value) -> bool {
+			return read_all(fd, std::as_writable_bytes(std::span<T>(&value, 1)));
+		}
+
+		template<typename T>
+		auto write_value(int fd, T const& value) -> bool {
+			return write_all(fd, std::as_bytes(std::span<T const>(&value, 1)));
+		}
+
+		// Runs in a forked worker until the parent closes its end of the socket.
+		auto serve(std::string const& name,
+		           vector_store::size_type first,
+		           vector_store::size_type last,
+		           int fd) -> void {
+			auto const store = vector_store::attach(name);
+			auto query = std::vector<double>(static_cast<std::size_t>(store.dimensions()));
+			auto k = vector_store::size_type{0};
+			while (read_value(fd, k) and read_all(fd, std::as_writable_bytes(std::span(query)))) {
+				auto const results = store.top_k(euclidean_vector_view(query), k, first, last);
+				auto const count = static_cast<std::int64_t>(results.size());
+				if (not write_value(fd, count)
+				    or not write_all(fd, std::as_bytes(std::span(results)))) {
+					return;
+				}
+			}
+		}
+	} // namespace
+
+	vector_store::vector_store(void* address, std::size_t bytes, bool writable) noexcept
+	: address_{address}
+	, bytes_{bytes}
+	, writable_{writable} {}
+
+	vector_store::vector_store(vector_store&& other) noexcept
+	: address_{std::exchange(other.address_, nullptr)}
+	, bytes_{std::exchange(other.bytes_, 0)}
+	, writable_{std::exchange(other.writable_, false)} {}
+
+	vector_store::~vector_store() {
+		if (address_ != nullptr) {
+			::munmap(address_, bytes_);
+		}
+	}
+
+	auto vector_store::operator=(vector_store&& other) noexcept -> vector_store& {
+		std::swap(address_, other.address_);
+		std::swap(bytes_, other.bytes_);
+		std::swap(writable_, other.writable_);
+		return *this;
+	}
+
+	auto vector_store::create(std::string const& name, size_type size, size_type dimensions)
+	   -> vector_store {
+		auto const bytes = segment_bytes(size, dimensions);
+		if (bytes == 0) {
+			throw vector_store_error(fmt::format("Cannot create {} with {} vectors of {} dimensions",
+			                                     name,
+			                                     size,
+			                                     dimensions));
+		}
+		auto const fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+		if (fd == -1) {
+			throw store_error("create", name);
+		}
+		if (::ftruncate(fd, gsl_lite::narrow_cast<off_t>(bytes)) == -1) {
+			auto const error = store_error("resize", name);
+			::close(fd);
+			::shm_unlink(name.c_str());
+			throw error;
+		}
+		auto* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		auto const saved_errno = errno;
+		::close(fd);
+		if (address == MAP_FAILED) {
+			errno = saved_errno;
+			::shm_unlink(name.c_str());
+			throw store_error("map", name);
+		}
+
+		auto result = vector_store(address, bytes, true);
+		auto* h = static_cast<header*>(address);
+		h->magic = 0;
+		h->size = size;
+		h->dimensions = dimensions;
+		return result;
+	}
+
+	auto vector_store::attach(std::string const& name) -> vector_store {
+		auto const fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+		if (fd == -1) {
+			throw store_error("attach to", name);
+		}
+		struct stat status = {};
+		if (::fstat(fd, &status) == -1) {
+			auto const error = store_error("stat", name);
+			::close(fd);
+			throw error;
+		}
+		auto const bytes = gsl_lite::narrow_cast<std::size_t>(status.st_size);
+		if (bytes < data_offset) {
+			::close(fd);
+			throw vector_store_error(fmt::format("{} is not a vector_store", name));
+		}
+		auto* address = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+		auto const saved_errno = errno;
+		::close(fd);
+		if (address == MAP_FAILED) {
+			errno = saved_errno;
+			throw store_error("map", name);
+		}
+
+		auto result = vector_store(address, bytes, false);
+		auto& h = result.info();
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+		auto magic = std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(h.magic));
+		if (magic.load(std::memory_order_acquire) != published) {
+			throw vector_store_error(fmt::format("{} has not been published", name));
+		}
+		auto const expected = segment_bytes(h.size, h.dimensions);
+		if (expected == 0 or bytes < expected) {
+			throw vector_store_error(fmt::format("{} is truncated or not a vector_store", name));
+		}
+		return result;
+	}
+
+	auto vector_store::remove(std::string const& name) -> void {
+		if (::shm_unlink(name.c_str()) == -1 and errno != ENOENT) {
+			throw store_error("remove", name);
+		}
+	}
+
+	auto vector_store::assign(size_type i, euclidean_vector_view v) -> void {
+		if (not writable_) {
+			throw vector_store_error("Cannot assign to a published vector_store");
+		}
+		if (v.dimensions() != dimensions()) {
+			throw vector_store_error(fmt::format("Dimensions of store({}) and vector({}) do not "
+			                                     "match",
+			                                     dimensions(),
+			                                     v.dimensions()));
+		}
+		if (i < 0 or i >= size()) {
+			throw vector_store_error(fmt::format("Index {} is not valid for this vector_store", i));
+		}
+		auto const magnitudes = v.magnitudes();
+		auto const offset = gsl_lite::narrow_cast<std::size_t>(i * dimensions());
+		std::copy(magnitudes.begin(), magnitudes.end(), data() + offset);
+	}
+
+	auto vector_store::publish() -> void {
+		if (not writable_) {
+			throw vector_store_error("Cannot publish a vector_store twice");
+		}
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+		auto magic = std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(info().magic));
+		magic.store(published, std::memory_order_release);
+		writable_ = false;
+		if (::mprotect(address_, bytes_, PROT_READ) == -1) {
+			throw vector_store_error(
+			   fmt::format("Cannot protect a published vector_store: {}", std::strerror(errno)));
+		}
+	}
+
+	auto vector_store::operator[](size_type i) const noexcept -> euclidean_vector_view {
+		assert(i >= 0 and i < size());
+		auto const d = gsl_lite::narrow_cast<std::size_t>(dimensions());
+		return euclidean_vector_view(
+		   std::span<double const>(data() + gsl_lite::narrow_cast<std::size_t>(i) * d, d));
+	}
+
+	auto vector_store::at(size_type i) const -> euclidean_vector_view {
+		if (i < 0 or i >= size()) {
+			throw vector_store_error(fmt::format("Index {} is not valid for this vector_store", i));
+		}
+		return (*this)[i];
+	}
+
+	auto vector_store::size() const noexcept -> size_type {
+		return info().size;
+	}
+
+	auto vector_store::dimensions() const noexcept -> size_type {
+		return info().dimensions;
+	}
+
+	auto vector_store::writable() const noexcept -> bool {
+		return writable_;
+	}
+
+	auto vector_store::top_k(euclidean_vector_view query,
+	                         size_type k,
+	                         size_type first,
+	                         size_type last) const -> std::vector<search_result> {
+		if (query.dimensions() != dimensions()) {
+			throw vector_store_error(fmt::format("Dimensions of store({}) and query({}) do not "
+			                                     "match",
+			                                     dimensions(),
+			                                     query.dimensions()));
+		}
+		first = std::clamp(first, size_type{0}, size());
+		last = std::clamp(last, first, size());
+
+		// A heap ordered by `better` keeps the worst of the current best k at its front.
+		auto heap = std::vector<search_result>();
+		auto const capacity = std::clamp(k, size_type{0}, last - first);
+		heap.reserve(gsl_lite::narrow_cast<std::size_t>(capacity));
+		for (auto i = first; i < last and k > 0; ++i) {
+			auto const candidate = search_result{i, dot(query, (*this)[i])};
+			if (std::ssize(heap) < k) {
+				heap.push_back(candidate);
+				std::push_heap(heap.begin(), heap.end(), better);
+			}
+			else if (better(candidate, heap.front())) {
+				std::pop_heap(heap.begin(), heap.end(), better);
+				heap.back() = candidate;
+				std::push_heap(heap.begin(), heap.end(), better);
+			}
+		}
+		std::sort_heap(heap.begin(), heap.end(), better);
+		return heap;
+	}
+
+	auto vector_store::top_k(euclidean_vector_view query, size_type k) const
+	   -> std::vector<search_result> {
+		return top_k(query, k, 0, size());
+	}
+
+	auto vector_store::data() const noexcept -> double* {
+		return reinterpret_cast<double*>(static_cast<std::byte*>(address_) + data_offset); // NOLINT
+	}
+
+	auto vector_store::info() const noexcept -> header const& {
+		return *static_cast<header const*>(address_);
+	}
+
+	shard_pool::shard_pool(std::string const& name, int workers) {
+		auto const store = vector_store::attach(name);
+		dimensions_ = store.dimensions();
+		auto const size = store.size();
+		workers = std::max(workers, 1);
+		// Reserved up front so recording a forked worker can't throw.
+		workers_.reserve(static_cast<std::size_t>(workers));
+		try {
+			spawn(name, size, workers);
+		} catch (...) {
+			shutdown();
+			throw;
+		}
+	}
+
+	auto shard_pool::spawn(std::string const& name, size_type size, int workers) -> void {
+		for (auto w = 0; w < workers; ++w) {
+			auto sockets = std::array<int, 2>{};
+			if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets.data()) == -1) {
+				throw store_error("open a socket for", name);
+			}
+			auto const first = size * w / workers;
+			auto const last = size * (w + 1) / workers;
+			auto const pid = ::fork();
+			if (pid == -1) {
+				auto const error = store_error("fork a worker for", name);
+				::close(sockets[0]);
+				::close(sockets[1]);
+				throw error;
+			}
+			if (pid == 0) {
+				// Drop the parent's ends, including earlier workers', so they see EOF on shutdown.
+				::close(sockets[0]);
+				for (auto const& other : workers_) {
+					::close(other.socket);
+				}
+				try {
+					serve(name, first, last, sockets[1]);
+				} catch (...) {
+					::_exit(1);
+				}
+				::_exit(0);
+			}
+			::close(sockets[1]);
+			workers_.push_back(worker{pid, sockets[0]});
+		}
+	}
+
+	shard_pool::shard_pool(shard_pool&& other) noexcept
+	: dimensions_{other.dimensions_}
+	, workers_{std::exchange(other.workers_, {})}
+	, broken_{other.broken_} {}
+
+	shard_pool::~shard_pool() {
+		shutdown();
+	}
+
+	auto shard_pool::shutdown() const noexcept -> void {
+		for (auto const& w : workers_) {
+			::close(w.socket);
+		}
+		for (auto const& w : workers_) {
+			auto status = 0;
+			while (::waitpid(w.pid, &status, 0) == -1 and errno == EINTR) {
+			}
+		}
+		workers_.clear();
+	}
+
+	auto shard_pool::top_k(euclidean_vector_view query, size_type k) const
+	   -> std::vector<search_result> {
+		if (query.dimensions() != dimensions_) {
+			throw vector_store_error(fmt::format("Dimensions of store({}) and query({}) do not "
+			                                     "match",
+			                                     dimensions_,
+			                                     query.dimensions()));
+		}
+		// Every request goes out before any response is read, so the shards are scored in parallel.
+		auto const lock = std::lock_guard(mutex_);
+		if (broken_) {
+			throw vector_store_error("Cannot query a shard_pool after one of its workers stopped "
+			                         "responding");
+		}
+		// Replies still queued on the other sockets would answer the next query, so no worker is
+		// kept once one has failed.
+		auto const stopped = [this](worker const& w) {
+			auto const error = vector_store_error(fmt::format("Worker {} stopped responding", w.pid));
+			broken_ = true;
+			shutdown();
+			return error;
+		};
+		auto const request = std::as_bytes(query.magnitudes());
+		for (auto const& w : workers_) {
+			if (not write_value(w.socket, k) or not write_all(w.socket, request)) {
+				throw stopped(w);
+			}
+		}
+
+		auto merged = std::vector<search_result>();
+		for (auto const& w : workers_) {
+			auto count = std::int64_t{0};
+			if (not read_value(w.socket, count) or count < 0 or count > std::max(k, size_type{0})) {
+				throw stopped(w);
+			}
+			auto const offset = merged.size();
+			merged.resize(offset + static_cast<std::size_t>(count));
+			auto partial = std::span(merged).subspan(offset);
+			if (not read_all(w.socket, std::as_writable_bytes(partial))) {
+				throw stopped(w);
+			}
+		}
+
+		auto const keep = std::clamp(k, size_type{0}, std::ssize(merged));
+		std::partial_sort(merged.begin(), merged.begin() + keep, merged.end(), better);
+		merged.resize(gsl_lite::narrow_cast<std::size_t>(keep));
+		return merged;
+	}
+
+	auto shard_pool::workers() const noexcept -> int {
+		auto const lock = std::lock_guard(mutex_);
+		return static_cast<int>(workers_.size());
+	}
+} // namespace comp6771
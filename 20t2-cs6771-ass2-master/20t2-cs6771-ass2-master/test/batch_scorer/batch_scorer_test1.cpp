@@ -0,0 +1,136 @@
+#include "comp6771/batch_scorer.hpp"
+
+#include "comp6771/euclidean_vector.hpp"
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstddef>
+#include <latch>
+#include <utility>
+#include <vector>
+
+namespace {
+	auto make_model() -> std::vector<comp6771::euclidean_vector> {
+		return {comp6771::euclidean_vector{1, 0},
+		        comp6771::euclidean_vector{0, 1},
+		        comp6771::euclidean_vector{1, 1}};
+	}
+
+	auto score_into(comp6771::batch_scorer& scorer,
+	                comp6771::euclidean_vector query,
+	                comp6771::score_result& out,
+	                std::latch& done) -> comp6771::detached_task {
+		out = co_await scorer.score(std::move(query));
+		done.count_down();
+	}
+
+	// Keeps scoring until `remaining` reaches zero, so each query is submitted from inside the
+	// previous one's resumption.
+	auto score_chain(comp6771::batch_scorer& scorer, int remaining, std::atomic<int>& completed)
+	   -> comp6771::detached_task {
+		while (remaining-- > 0) {
+			auto query = comp6771::euclidean_vector{1, 2};
+			auto const result = co_await scorer.score(std::move(query));
+			if (result.dots[2] == 3) {
+				++completed;
+			}
+		}
+	}
+} // namespace
+
+TEST_CASE("latency_histogram") {
+	auto h = comp6771::latency_histogram();
+	CHECK(h.count() == 0);
+	CHECK(h.percentile(99) == std::chrono::nanoseconds(0));
+
+	for (auto i = 1; i <= 100; ++i) {
+		h.record(std::chrono::microseconds(i));
+	}
+	CHECK(h.count() == 100);
+	auto const p50 = h.percentile(50);
+	CHECK(p50 >= std::chrono::microseconds(50));
+	CHECK(p50 <= std::chrono::microseconds(50) * 17 / 16);
+	auto const p99 = h.percentile(99);
+	CHECK(p99 >= std::chrono::microseconds(99));
+	CHECK(p99 <= std::chrono::microseconds(99) * 17 / 16);
+	CHECK(h.percentile(100) >= std::chrono::microseconds(100));
+
+	auto other = comp6771::latency_histogram();
+	other.record(std::chrono::nanoseconds(3));
+	h.merge(other);
+	CHECK(h.count() == 101);
+	CHECK(h.percentile(0) == std::chrono::nanoseconds(3));
+}
+
+TEST_CASE("batch_scorer") {
+	SECTION("results") {
+		auto scorer = comp6771::batch_scorer(make_model());
+		auto result = comp6771::score_result();
+		auto done = std::latch(1);
+		score_into(scorer, comp6771::euclidean_vector{3, 4}, result, done);
+		done.wait();
+		CHECK(result.dots == std::vector<double>{3, 4, 7});
+		CHECK(result.norm == 5);
+		CHECK(scorer.latencies().count() == 1);
+	}
+
+	SECTION("micro-batching") {
+		auto opts = comp6771::batch_scorer::options{};
+		opts.max_batch = 8;
+		opts.deadline = std::chrono::seconds(10);
+		auto scorer = comp6771::batch_scorer(make_model(), opts);
+
+		auto results = std::vector<comp6771::score_result>(16);
+		auto done = std::latch(16);
+		for (auto i = std::size_t{0}; i < results.size(); ++i) {
+			auto const x = static_cast<double>(i);
+			score_into(scorer, comp6771::euclidean_vector{x, 1}, results[i], done);
+		}
+		done.wait();
+		CHECK(scorer.batches() == 2);
+		CHECK(results[5].dots == std::vector<double>{5, 1, 6});
+	}
+
+	SECTION("deadline closes partial batches") {
+		auto opts = comp6771::batch_scorer::options{};
+		opts.max_batch = 1000;
+		opts.deadline = std::chrono::milliseconds(1);
+		auto scorer = comp6771::batch_scorer(make_model(), opts);
+		auto result = comp6771::score_result();
+		auto done = std::latch(1);
+		score_into(scorer, comp6771::euclidean_vector{1, 1}, result, done);
+		done.wait();
+		CHECK(result.dots[2] == 2);
+	}
+
+	SECTION("destruction flushes pending queries") {
+		auto completed = std::atomic<int>(0);
+		{
+			auto opts = comp6771::batch_scorer::options{};
+			opts.deadline = std::chrono::hours(1);
+			auto scorer = comp6771::batch_scorer(make_model(), opts);
+			score_chain(scorer, 5, completed);
+			score_chain(scorer, 3, completed);
+		}
+		CHECK(completed == 8);
+	}
+
+	SECTION("dimension mismatch") {
+		auto scorer = comp6771::batch_scorer(make_model());
+		CHECK_THROWS_MATCHES(scorer.score(comp6771::euclidean_vector(3)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("Dimensions of LHS(3) and RHS(2) do not "
+		                                              "match"));
+	}
+
+	SECTION("queries with no dimensions are rejected before they reach a worker") {
+		auto scorer = comp6771::batch_scorer({});
+		CHECK_THROWS_MATCHES(scorer.score(comp6771::euclidean_vector(0)),
+		                     comp6771::euclidean_vector_error,
+		                     Catch::Matchers::Message("euclidean_vector with no dimensions does not "
+		                                              "have a norm"));
+		auto empty_rows = comp6771::batch_scorer({comp6771::euclidean_vector(0)});
+		CHECK_THROWS_AS(empty_rows.score(comp6771::euclidean_vector(0)),
+		                comp6771::euclidean_vector_error);
+	}
+}
@@ -1,10 +1,17 @@
 #include "comp6771/euclidean_vector.hpp"
 
+#include <absl/container/flat_hash_map.h>
+#include <absl/hash/hash.h>
 #include <catch2/catch.hpp>
+#include <cmath>
+#include <filesystem>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
+#include <functional>
 #include <limits>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 /*
@@ -131,6 +138,20 @@ TEST_CASE("== and != friends") {
 		CHECK_FALSE(a != b);
 		CHECK(a != d);
 	}
+
+	SECTION("== across blocks") {
+		auto const v = std::vector<double>(19, 1.5);
+		auto const a = comp6771::euclidean_vector(v.begin(), v.end());
+		auto b = a;
+		CHECK(a == b);
+		b[3] = 2;
+		CHECK_FALSE(a == b);
+		b[3] = 1.5;
+		b[18] = 2;
+		CHECK_FALSE(a == b);
+		b[18] = std::numeric_limits<double>::quiet_NaN();
+		CHECK_FALSE(a == b);
+	}
 }
 
 /*
@@ -433,3 +454,158 @@ TEST_CASE("miscellaneous") {
 		CHECK(norm5 == norm7);
 	}
 }
+
+/*
+   File-backed vectors behave like heap-backed ones, write through to
+   their file, and stream across chunk boundaries correctly
+*/
+TEST_CASE("file-backed storage") {
+	auto const path =
+	   (std::filesystem::temp_directory_path() / "euclidean_vector_test1.bin").string();
+
+	SECTION("dimensions are 64-bit") {
+		CHECK(std::numeric_limits<comp6771::euclidean_vector::size_type>::max()
+		      > std::numeric_limits<int>::max());
+	}
+
+	SECTION("create and map") {
+		{
+			auto a = comp6771::euclidean_vector::create_file(path, 3, 2);
+			CHECK(a.is_file_backed());
+			CHECK(a == comp6771::euclidean_vector{2, 2, 2});
+			a.at(1) = 5;
+		}
+		auto const b = comp6771::euclidean_vector::map_file(path);
+		CHECK(b.is_file_backed());
+		CHECK(b == comp6771::euclidean_vector{2, 5, 2});
+
+		auto const c = b;
+		CHECK_FALSE(c.is_file_backed());
+		CHECK(c == b);
+	}
+
+	SECTION("operations stream across chunks") {
+		auto const dimensions = comp6771::euclidean_vector::size_type{(1 << 21) + 3};
+		auto a = comp6771::euclidean_vector::create_file(path, dimensions, 1);
+		auto const b = comp6771::euclidean_vector(dimensions, 2);
+		CHECK(comp6771::dot(a, b) == 2.0 * static_cast<double>(dimensions));
+		a += b;
+		a *= 2;
+		CHECK(a[0] == 6);
+		CHECK(a[dimensions - 1] == 6);
+		CHECK(comp6771::euclidean_norm(a) == std::sqrt(36.0 * static_cast<double>(dimensions)));
+	}
+
+	SECTION("create errors leave an existing file alone") {
+		using size_type = comp6771::euclidean_vector::size_type;
+		comp6771::euclidean_vector::create_file(path, 2, 7);
+		for (auto const dimensions : {size_type{-1},
+		                              std::numeric_limits<size_type>::min(),
+		                              std::numeric_limits<size_type>::max()}) {
+			CHECK_THROWS_MATCHES(comp6771::euclidean_vector::create_file(path, dimensions),
+			                     comp6771::euclidean_vector_error,
+			                     Catch::Matchers::Message(
+			                        fmt::format("Cannot create a file-backed euclidean_vector with {} "
+			                                    "dimensions",
+			                                    dimensions)));
+		}
+		CHECK(comp6771::euclidean_vector::map_file(path) == comp6771::euclidean_vector{7, 7});
+	}
+
+	SECTION("map errors") {
+		CHECK_THROWS_AS(comp6771::euclidean_vector::map_file(path + ".missing"),
+		                comp6771::euclidean_vector_error);
+	}
+
+	std::filesystem::remove(path);
+}
+
+// The counters are compiled out unless COMP6771_EUCLIDEAN_VECTOR_STATS is set,
+// in which case every hook should be visible in a snapshot
+TEST_CASE("stats") {
+	comp6771::reset_stats();
+	auto a = comp6771::euclidean_vector{3, 4};
+	auto b = a;
+	auto c = std::move(b);
+	CHECK(comp6771::euclidean_norm(c) == 5);
+	CHECK(comp6771::euclidean_norm(c) == 5);
+
+	auto const stats = comp6771::stats_snapshot();
+	if constexpr (comp6771::stats_enabled) {
+		CHECK(stats.allocations == 2);
+		CHECK(stats.copies == 1);
+		CHECK(stats.moves == 1);
+		CHECK(stats.norm_cache_hits == 1);
+		CHECK(stats.norm_cache_misses == 1);
+
+		comp6771::reset_stats();
+		CHECK(comp6771::stats_snapshot().allocations == 0);
+
+		std::thread([] { auto const d = comp6771::euclidean_vector(3); }).join();
+		CHECK(comp6771::stats_snapshot().allocations == 1);
+	}
+	else {
+		CHECK(stats.allocations == 0);
+		CHECK(stats.norm_cache_misses == 0);
+	}
+}
+
+TEST_CASE("hashing") {
+	SECTION("equal vectors hash equally") {
+		auto const a = comp6771::euclidean_vector{1, 2, 3};
+		auto const b = comp6771::euclidean_vector{1, 2, 3};
+		auto const c = comp6771::euclidean_vector{1, 2, 4};
+		CHECK(a.hash() == b.hash());
+		CHECK(std::hash<comp6771::euclidean_vector>{}(a) == a.hash());
+		CHECK(a.hash() != c.hash());
+		CHECK(comp6771::euclidean_vector{0.0}.hash() == comp6771::euclidean_vector{-0.0}.hash());
+	}
+
+	SECTION("cache invalidation") {
+		auto a = comp6771::euclidean_vector{1, 2, 3};
+		auto const before = a.hash();
+		a[0] = 5;
+		CHECK(a.hash() != before);
+		CHECK(a.hash() == comp6771::euclidean_vector{5, 2, 3}.hash());
+		CHECK((-a).hash() == comp6771::euclidean_vector{-5, -2, -3}.hash());
+	}
+
+	SECTION("exact_equal") {
+		auto const eq = comp6771::exact_equal();
+		auto const close = comp6771::euclidean_vector{1 + std::numeric_limits<double>::epsilon(), 2};
+		CHECK(eq(comp6771::euclidean_vector{1, 2}, comp6771::euclidean_vector{1, 2}));
+		CHECK(eq(comp6771::euclidean_vector{0.0, 1}, comp6771::euclidean_vector{-0.0, 1}));
+		CHECK(close == comp6771::euclidean_vector{1, 2});
+		CHECK_FALSE(eq(close, comp6771::euclidean_vector{1, 2}));
+		CHECK_FALSE(eq(comp6771::euclidean_vector{1}, comp6771::euclidean_vector{1, 0}));
+	}
+
+	SECTION("absl::flat_hash_map keys") {
+		using key = comp6771::euclidean_vector;
+		auto scores = absl::flat_hash_map<key, double, absl::Hash<key>, comp6771::exact_equal>();
+		scores[key{1, 2}] = 0.5;
+		scores[key{2, 1}] = 0.25;
+		CHECK(scores.size() == 2);
+		CHECK(scores.at(key{1, 2}) == 0.5);
+		scores[key{0.0, 1}] = 1;
+		CHECK(scores.at(key{-0.0, 1}) == 1);
+		CHECK_FALSE(scores.contains(key{1, 3}));
+
+		// Equal under operator==, but a different key.
+		auto const close = key{1 + std::numeric_limits<double>::epsilon(), 2};
+		CHECK_FALSE(scores.contains(close));
+		scores[close] = 1;
+		CHECK(scores.size() == 4);
+		CHECK(scores.at(key{1, 2}) == 0.5);
+	}
+
+	SECTION("std::unordered_map keys") {
+		using key = comp6771::euclidean_vector;
+		auto counts = std::unordered_map<key, int, std::hash<key>, comp6771::exact_equal>();
+		++counts[key{0.0, 3}];
+		++counts[key{-0.0, 3}];
+		++counts[key{std::numeric_limits<double>::epsilon(), 3}];
+		CHECK(counts.size() == 2);
+		CHECK(counts.at(key{0.0, 3}) == 2);
+	}
+}
@@ -0,0 +1,194 @@
+#include "comp6771/vector_store.hpp"
+
+#include "comp6771/euclidean_vector.hpp"
+#include <catch2/catch.hpp>
+#include <csignal>
+#include <cstdint>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+	auto const store_name = std::string("/comp6771_vector_store_test1");
+
+	// Vectors along the diagonal, scaled by their index, so the best match for any positive
+	// query is the one with the largest index.
+	auto make_store(comp6771::vector_store::size_type size) -> comp6771::vector_store {
+		comp6771::vector_store::remove(store_name);
+		auto store = comp6771::vector_store::create(store_name, size, 2);
+		for (auto i = comp6771::vector_store::size_type{0}; i < size; ++i) {
+			auto const magnitude = static_cast<double>(i);
+			store.assign(i, comp6771::euclidean_vector{magnitude, magnitude});
+		}
+		store.publish();
+		return store;
+	}
+
+	// The IDs of this process's children, read from the parent field of each /proc/<pid>/stat.
+	auto children() -> std::vector<pid_t> {
+		auto result = std::vector<pid_t>();
+		for (auto const& entry : std::filesystem::directory_iterator("/proc")) {
+			auto stat = std::ifstream(entry.path() / "stat");
+			auto line = std::string();
+			if (not std::getline(stat, line) or line.rfind(')') == std::string::npos) {
+				continue;
+			}
+			// The command name can hold spaces, so the fields are read from after its ')'.
+			auto fields = std::istringstream(line.substr(line.rfind(')') + 1));
+			auto state = char{};
+			auto parent = pid_t{0};
+			if (fields >> state >> parent and parent == ::getpid()) {
+				result.push_back(std::stoi(entry.path().filename().string()));
+			}
+		}
+		return result;
+	}
+} // namespace
+
+TEST_CASE("views") {
+	auto const a = comp6771::euclidean_vector{3, 4};
+	auto const view = comp6771::euclidean_vector_view(a);
+	CHECK(view.dimensions() == 2);
+	CHECK(view[1] == 4);
+	CHECK(comp6771::euclidean_norm(view) == 5);
+	CHECK(comp6771::dot(view, comp6771::euclidean_vector{1, 1}) == 7);
+	CHECK_THROWS_AS(view.at(2), comp6771::euclidean_vector_error);
+	CHECK_THROWS_AS(comp6771::dot(view, comp6771::euclidean_vector(3)),
+	                comp6771::euclidean_vector_error);
+}
+
+TEST_CASE("loader and readers") {
+	auto loader = make_store(10);
+	CHECK_FALSE(loader.writable());
+	CHECK_THROWS_MATCHES(loader.publish(),
+	                     comp6771::vector_store_error,
+	                     Catch::Matchers::Message("Cannot publish a vector_store twice"));
+
+	SECTION("attach in process") {
+		auto const reader = comp6771::vector_store::attach(store_name);
+		CHECK(reader.size() == 10);
+		CHECK(reader.dimensions() == 2);
+		CHECK(reader[3].magnitudes().data() != loader[3].magnitudes().data());
+		CHECK(comp6771::dot(reader[3], reader[2]) == 12);
+		CHECK(comp6771::euclidean_norm(reader.at(0)) == 0);
+	}
+
+	SECTION("attach from a forked reader") {
+		auto const pid = ::fork();
+		if (pid == 0) {
+			auto const reader = comp6771::vector_store::attach(store_name);
+			::_exit(comp6771::dot(reader[9], comp6771::euclidean_vector{1, 0}) == 9 ? 0 : 1);
+		}
+		auto status = 0;
+		::waitpid(pid, &status, 0);
+		CHECK(WIFEXITED(status));
+		CHECK(WEXITSTATUS(status) == 0);
+	}
+
+	SECTION("top_k") {
+		auto const results = loader.top_k(comp6771::euclidean_vector{1, 1}, 3);
+		REQUIRE(results.size() == 3);
+		CHECK(results[0].index == 9);
+		CHECK(results[1].index == 8);
+		CHECK(results[2].index == 7);
+		CHECK(results[0].score == 18);
+		CHECK(loader.top_k(comp6771::euclidean_vector{1, 1}, 20).size() == 10);
+	}
+
+	SECTION("sharded top_k") {
+		auto const pool = comp6771::shard_pool(store_name, 3);
+		CHECK(pool.workers() == 3);
+		auto const expected = loader.top_k(comp6771::euclidean_vector{-1, 2}, 4);
+		auto const actual = pool.top_k(comp6771::euclidean_vector{-1, 2}, 4);
+		REQUIRE(actual.size() == expected.size());
+		for (auto i = std::size_t{0}; i < actual.size(); ++i) {
+			CHECK(actual[i].index == expected[i].index);
+			CHECK(actual[i].score == expected[i].score);
+		}
+		CHECK(pool.top_k(comp6771::euclidean_vector{1, 1}, 1)[0].index == 9);
+	}
+
+	SECTION("sharded top_k from several threads") {
+		auto const pool = comp6771::shard_pool(store_name, 2);
+		auto mismatches = std::vector<int>(4);
+		auto threads = std::vector<std::thread>();
+		for (auto t = std::size_t{0}; t < mismatches.size(); ++t) {
+			threads.emplace_back([&pool, &loader, &mismatches, t] {
+				auto const query = comp6771::euclidean_vector{1, -static_cast<double>(t)};
+				for (auto i = 0; i < 200; ++i) {
+					auto const expected = loader.top_k(query, 3);
+					auto const actual = pool.top_k(query, 3);
+					for (auto j = std::size_t{0}; j < actual.size(); ++j) {
+						mismatches[t] += actual[j].index == expected[j].index ? 0 : 1;
+					}
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		CHECK(mismatches == std::vector<int>(4));
+	}
+
+	SECTION("sharded top_k after a worker dies") {
+		auto const pool = comp6771::shard_pool(store_name, 3);
+		REQUIRE(pool.top_k(comp6771::euclidean_vector{1, 1}, 1)[0].index == 9);
+		auto const workers = children();
+		REQUIRE(workers.size() == 3);
+		::kill(workers[1], SIGKILL);
+		CHECK_THROWS_AS(pool.top_k(comp6771::euclidean_vector{1, 1}, 1),
+		                comp6771::vector_store_error);
+		CHECK_THROWS_MATCHES(pool.top_k(comp6771::euclidean_vector{1, 1}, 1),
+		                     comp6771::vector_store_error,
+		                     Catch::Matchers::Message("Cannot query a shard_pool after one of its "
+		                                              "workers stopped responding"));
+		CHECK(pool.workers() == 0);
+		CHECK(children().empty());
+	}
+
+	comp6771::vector_store::remove(store_name);
+}
+
+TEST_CASE("vector_store errors") {
+	comp6771::vector_store::remove(store_name);
+	CHECK_THROWS_AS(comp6771::vector_store::attach(store_name), comp6771::vector_store_error);
+
+	auto store = comp6771::vector_store::create(store_name, 2, 3);
+	CHECK_THROWS_MATCHES(comp6771::vector_store::attach(store_name),
+	                     comp6771::vector_store_error,
+	                     Catch::Matchers::Message(store_name + " has not been published"));
+	CHECK_THROWS_MATCHES(store.assign(0, comp6771::euclidean_vector(2)),
+	                     comp6771::vector_store_error,
+	                     Catch::Matchers::Message("Dimensions of store(3) and vector(2) do not "
+	                                              "match"));
+	CHECK_THROWS_MATCHES(store.assign(2, comp6771::euclidean_vector(3)),
+	                     comp6771::vector_store_error,
+	                     Catch::Matchers::Message("Index 2 is not valid for this vector_store"));
+	store.publish();
+	CHECK_THROWS_MATCHES(store.assign(0, comp6771::euclidean_vector(3)),
+	                     comp6771::vector_store_error,
+	                     Catch::Matchers::Message("Cannot assign to a published vector_store"));
+
+	// The header still claims 2 vectors of 3 dimensions.
+	auto const fd = ::shm_open(store_name.c_str(), O_RDWR, 0);
+	REQUIRE(fd != -1);
+	CHECK(::ftruncate(fd, 100) == 0);
+	::close(fd);
+	CHECK_THROWS_MATCHES(comp6771::vector_store::attach(store_name),
+	                     comp6771::vector_store_error,
+	                     Catch::Matchers::Message(store_name
+	                                              + " is truncated or not a vector_store"));
+	comp6771::vector_store::remove(store_name);
+
+	CHECK_THROWS_AS(comp6771::vector_store::create(store_name, -1, 3), comp6771::vector_store_error);
+	CHECK_THROWS_AS(comp6771::vector_store::create(store_name, std::int64_t{1} << 40, 1 << 20),
+	                comp6771::vector_store_error);
+	comp6771::vector_store::remove(store_name);
+}
@@ -0,0 +1,149 @@
+#include "gdwg/concurrent_graph.hpp"
+
+#include "gdwg/graph.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	struct options {
+		int readers;
+		int writers;
+		int milliseconds;
+		int nodes;
+		int edges;
+	};
+
+	struct counts {
+		long reads;
+		long writes;
+	};
+
+	// The baseline: an ordinary graph where every reader takes a shared lock and every writer an
+	// exclusive one.
+	class locked_graph {
+	public:
+		auto insert_node(int value) -> void {
+			auto const lock = std::unique_lock(mutex_);
+			graph_.insert_node(value);
+		}
+
+		auto insert_edge(int src, int dst, int weight) -> void {
+			auto const lock = std::unique_lock(mutex_);
+			graph_.insert_edge(src, dst, weight);
+		}
+
+		auto erase_edge(int src, int dst, int weight) -> void {
+			auto const lock = std::unique_lock(mutex_);
+			graph_.erase_edge(src, dst, weight);
+		}
+
+		auto is_connected(int src, int dst) const -> bool {
+			auto const lock = std::shared_lock(mutex_);
+			return graph_.is_connected(src, dst);
+		}
+
+		auto connections(int src) const -> std::vector<int> {
+			auto const lock = std::shared_lock(mutex_);
+			return graph_.connections(src);
+		}
+
+	private:
+		mutable std::shared_mutex mutex_;
+		gdwg::graph<int, int> graph_;
+	};
+
+	template<typename Graph>
+	auto run(Graph& g, options const& o) -> counts {
+		auto rng = std::mt19937(6771);
+		auto node = std::uniform_int_distribution<int>(0, o.nodes - 1);
+		for (auto i = 0; i < o.nodes; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < o.edges; ++i) {
+			g.insert_edge(node(rng), node(rng), i % 8);
+		}
+
+		auto stop = std::atomic<bool>{false};
+		auto reads = std::atomic<long>{0};
+		auto writes = std::atomic<long>{0};
+		{
+			auto threads = std::vector<std::jthread>();
+			for (auto r = 0; r < o.readers; ++r) {
+				threads.emplace_back([&, r] {
+					auto local_rng = std::mt19937(static_cast<unsigned>(r));
+					auto local = 0L;
+					while (not stop.load(std::memory_order_relaxed)) {
+						auto const src = node(local_rng);
+						auto const found = r % 2 == 0 ? g.is_connected(src, node(local_rng))
+						                              : not g.connections(src).empty();
+						static_cast<void>(found);
+						++local;
+					}
+					reads += local;
+				});
+			}
+			for (auto w = 0; w < o.writers; ++w) {
+				threads.emplace_back([&, w] {
+					auto local_rng = std::mt19937(static_cast<unsigned>(1000 + w));
+					auto local = 0L;
+					while (not stop.load(std::memory_order_relaxed)) {
+						auto const src = node(local_rng);
+						auto const dst = node(local_rng);
+						if (local % 2 == 0) {
+							g.insert_edge(src, dst, 9);
+						}
+						else {
+							g.erase_edge(src, dst, 9);
+						}
+						++local;
+					}
+					writes += local;
+				});
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(o.milliseconds));
+			stop = true;
+		}
+		return counts{reads.load(), writes.load()};
+	}
+
+	auto argument(int argc, char** argv, int i, int fallback) -> int {
+		return i < argc ? std::stoi(argv[i]) : fallback;
+	}
+
+	auto report(char const* name, counts const& c, options const& o) -> void {
+		auto const seconds = o.milliseconds / 1000.0;
+		fmt::print("{:<24} {:>14.0f} reads/s {:>12.0f} writes/s\n",
+		           name,
+		           static_cast<double>(c.reads) / seconds,
+		           static_cast<double>(c.writes) / seconds);
+	}
+} // namespace
+
+// usage: concurrent_graph_throughput [readers] [writers] [milliseconds] [nodes] [edges] [shards]
+auto main(int argc, char** argv) -> int {
+	auto const o = options{argument(argc, argv, 1, 8),
+	                       argument(argc, argv, 2, 1),
+	                       argument(argc, argv, 3, 2000),
+	                       argument(argc, argv, 4, 100'000),
+	                       argument(argc, argv, 5, 1'000'000)};
+	auto const shards = static_cast<std::size_t>(argument(argc, argv, 6, 64));
+	fmt::print("{} readers, {} writers, {} nodes, {} edges\n",
+	           o.readers,
+	           o.writers,
+	           o.nodes,
+	           o.edges);
+
+	auto baseline = locked_graph();
+	report("graph + shared_mutex", run(baseline, o), o);
+	auto concurrent = gdwg::concurrent_graph<int, int>(shards);
+	report("concurrent_graph", run(concurrent, o), o);
+	return EXIT_SUCCESS;
+}
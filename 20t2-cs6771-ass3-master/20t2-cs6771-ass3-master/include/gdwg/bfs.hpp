@@ -0,0 +1,268 @@
+#ifndef GDWG_BFS_HPP
+#define GDWG_BFS_HPP
+
+#include "gdwg/csr_view.hpp"
+#include "gdwg/detail/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// Hop counts and parent links from a set of sources, indexed by the csr_view's node IDs.
+	// Sources are their own parents. It refers to the view it was computed on, which must outlive
+	// it.
+	template<concepts::regular N, concepts::regular E>
+	class bfs_tree {
+	public:
+		using node_id = typename csr_view<N, E>::node_id;
+		static constexpr auto unreachable = std::numeric_limits<std::uint32_t>::max();
+		static constexpr auto no_parent = std::numeric_limits<node_id>::max();
+
+		bfs_tree(csr_view<N, E> const& view,
+		         std::vector<std::uint32_t> distances,
+		         std::vector<node_id> parents) noexcept
+		: view_{&view}
+		, distances_{std::move(distances)}
+		, parents_{std::move(parents)} {}
+
+		[[nodiscard]] auto reachable(N const& dst) const -> bool {
+			return distances_[view_->id(dst)] != unreachable;
+		}
+
+		// The number of edges on a shortest path from the nearest source, or unreachable.
+		[[nodiscard]] auto distance(N const& dst) const -> std::uint32_t {
+			return distances_[view_->id(dst)];
+		}
+
+		// The nodes on a shortest path from the nearest source to dst, including both ends. Empty if
+		// there is no path.
+		[[nodiscard]] auto path_to(N const& dst) const -> std::vector<N> {
+			auto id = view_->id(dst);
+			auto result = std::vector<N>();
+			if (distances_[id] == unreachable) {
+				return result;
+			}
+			for (; parents_[id] != id; id = parents_[id]) {
+				result.push_back(view_->node(id));
+			}
+			result.push_back(view_->node(id));
+			std::reverse(std::begin(result), std::end(result));
+			return result;
+		}
+
+		// Every node reachable from a source, sources included, in value order.
+		[[nodiscard]] auto reached() const -> std::vector<N> {
+			auto result = std::vector<N>();
+			for (auto id = node_id{0}; id < view_->node_count(); ++id) {
+				if (distances_[id] != unreachable) {
+					result.push_back(view_->node(id));
+				}
+			}
+			return result;
+		}
+
+		[[nodiscard]] auto distances() const noexcept -> std::span<std::uint32_t const> {
+			return distances_;
+		}
+
+		[[nodiscard]] auto parents() const noexcept -> std::span<node_id const> {
+			return parents_;
+		}
+
+	private:
+		csr_view<N, E> const* view_;
+		std::vector<std::uint32_t> distances_;
+		std::vector<node_id> parents_;
+	};
+
+	namespace detail {
+		// The switching thresholds from Beamer, Asanovic and Patterson, "Direction-Optimizing
+		// Breadth-First Search".
+		inline constexpr auto bfs_alpha = std::size_t{14};
+		inline constexpr auto bfs_beta = std::size_t{24};
+
+		class frontier_bitmap {
+		public:
+			explicit frontier_bitmap(std::size_t size)
+			: words_((size + 63) / 64) {}
+
+			[[nodiscard]] auto test(std::size_t i) const noexcept -> bool {
+				return ((words_[i / 64] >> (i % 64)) & 1U) != 0;
+			}
+
+			// Safe to call from several threads at once.
+			auto set(std::size_t i) noexcept -> void {
+				std::atomic_ref<std::uint64_t>(words_[i / 64])
+				   .fetch_or(std::uint64_t{1} << (i % 64), std::memory_order_relaxed);
+			}
+
+			auto clear() noexcept -> void {
+				std::fill(std::begin(words_), std::end(words_), std::uint64_t{0});
+			}
+
+			auto swap(frontier_bitmap& other) noexcept -> void {
+				words_.swap(other.words_);
+			}
+
+		private:
+			std::vector<std::uint64_t> words_;
+		};
+	} // namespace detail
+
+	// Level-synchronous parallel breadth-first search from every source at once. Each level is
+	// expanded either top-down, where frontier nodes claim their unvisited successors, or
+	// bottom-up, where each unvisited node scans its predecessors for one in the frontier bitmap.
+	// Bottom-up is used while the frontier's edges outnumber a fraction of the unvisited nodes'
+	// edges. Distances are deterministic. Where several parents are possible, which one is kept
+	// depends on thread timing.
+	template<concepts::regular N, concepts::regular E>
+	auto bfs(csr_view<N, E> const& g,
+	         std::vector<N> const& sources,
+	         unsigned threads = detail::default_threads()) -> bfs_tree<N, E> {
+		using tree = bfs_tree<N, E>;
+		using node_id = typename tree::node_id;
+		if (not std::all_of(std::cbegin(sources), std::cend(sources), [&g](N const& s) {
+			    return g.is_node(s);
+		    }))
+		{
+			throw std::runtime_error("Cannot call gdwg::bfs if a source doesn't exist in the graph");
+		}
+		threads = std::max(threads, 1U);
+
+		auto const n = std::size_t{g.node_count()};
+		auto const& out = g.forward();
+		auto const& in = g.reverse();
+		auto distances = std::vector<std::uint32_t>(n, tree::unreachable);
+		auto parents = std::vector<node_id>(n, tree::no_parent);
+
+		auto frontier = std::vector<node_id>();
+		for (auto const& source : sources) {
+			auto const s = g.id(source);
+			if (parents[s] == tree::no_parent) {
+				parents[s] = s;
+				distances[s] = 0;
+				frontier.push_back(s);
+			}
+		}
+		auto const add_degree = [&out](std::size_t total, node_id u) {
+			return total + out.degree(u);
+		};
+		auto const edges_from = [&add_degree](std::vector<node_id> const& nodes) {
+			return std::accumulate(std::cbegin(nodes), std::cend(nodes), std::size_t{0}, add_degree);
+		};
+		auto unvisited_edges = g.edge_count() - edges_from(frontier);
+		auto frontier_size = std::size(frontier);
+
+		auto current = detail::frontier_bitmap(n);
+		auto next = detail::frontier_bitmap(n);
+		auto next_lists = std::vector<std::vector<node_id>>(threads);
+		auto found = std::vector<std::pair<std::size_t, std::size_t>>(threads);
+		auto bottom_up = false;
+
+		for (auto level = std::uint32_t{0}; frontier_size != 0; ++level) {
+			if (not bottom_up) {
+				if (edges_from(frontier) > unvisited_edges / detail::bfs_alpha) {
+					bottom_up = true;
+					current.clear();
+					for (auto const u : frontier) {
+						current.set(u);
+					}
+				}
+			}
+			else if (frontier_size < n / detail::bfs_beta) {
+				bottom_up = false;
+				frontier.clear();
+				for (auto v = std::size_t{0}; v < n; ++v) {
+					if (current.test(v)) {
+						frontier.push_back(static_cast<node_id>(v));
+					}
+				}
+			}
+
+			std::fill(std::begin(found), std::end(found), std::pair<std::size_t, std::size_t>{});
+			if (bottom_up) {
+				next.clear();
+				auto const step = [&](std::size_t first, std::size_t last, unsigned thread) {
+					for (auto v = first; v < last; ++v) {
+						if (parents[v] != tree::no_parent) {
+							continue;
+						}
+						for (auto e = in.offsets[v]; e < in.offsets[v + 1]; ++e) {
+							auto const u = in.neighbours[e];
+							if (current.test(u)) {
+								parents[v] = u;
+								distances[v] = level + 1;
+								next.set(v);
+								++found[thread].first;
+								found[thread].second += out.degree(static_cast<node_id>(v));
+								break;
+							}
+						}
+					}
+				};
+				detail::parallel_for(threads, n, step);
+				current.swap(next);
+			}
+			else {
+				auto const step = [&](std::size_t first, std::size_t last, unsigned thread) {
+					auto& claimed = next_lists[thread];
+					for (auto i = first; i < last; ++i) {
+						auto const u = frontier[i];
+						for (auto e = out.offsets[u]; e < out.offsets[u + 1]; ++e) {
+							auto const v = out.neighbours[e];
+							auto parent = std::atomic_ref<node_id>(parents[v]);
+							auto unclaimed = tree::no_parent;
+							auto const relaxed = std::memory_order_relaxed;
+							if (parent.load(relaxed) == tree::no_parent
+							    and parent.compare_exchange_strong(unclaimed, u, relaxed)) {
+								distances[v] = level + 1;
+								claimed.push_back(v);
+								++found[thread].first;
+								found[thread].second += out.degree(v);
+							}
+						}
+					}
+				};
+				detail::parallel_for(threads, std::size(frontier), step);
+				frontier.clear();
+				for (auto& claimed : next_lists) {
+					frontier.insert(std::end(frontier), std::cbegin(claimed), std::cend(claimed));
+					claimed.clear();
+				}
+			}
+
+			frontier_size = 0;
+			for (auto const& [nodes, edges] : found) {
+				frontier_size += nodes;
+				unvisited_edges -= edges;
+			}
+		}
+		return tree(g, std::move(distances), std::move(parents));
+	}
+
+	template<concepts::regular N, concepts::regular E>
+	auto bfs(csr_view<N, E> const& g, N const& source, unsigned threads = detail::default_threads())
+	   -> bfs_tree<N, E> {
+		return bfs(g, std::vector<N>{source}, threads);
+	}
+
+	// Every node reachable from any of the sources, sources included, in value order.
+	template<concepts::regular N, concepts::regular E>
+	auto reachable_from(csr_view<N, E> const& g,
+	                    std::vector<N> const& sources,
+	                    unsigned threads = detail::default_threads()) -> std::vector<N> {
+		return bfs(g, sources, threads).reached();
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_BFS_HPP
@@ -0,0 +1,491 @@
+#ifndef GDWG_BINARY_IO_HPP
+#define GDWG_BINARY_IO_HPP
+
+#include "gdwg/csr_view.hpp"
+#include "gdwg/detail/graph_access.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <numeric>
+#include <ostream>
+#include <range/v3/iterator/operations.hpp>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The binary graph format. Integers are little-endian, and varints are unsigned LEB128.
+//    magic "GDWG", a four-byte format version, then the node and edge counts as varints
+//    every node value in ascending order, each written by the node serializer
+//    every edge in (from, to, weight) order: the distance from the previous edge's source as a
+//    varint; the distance from the previous edge's target as a varint when the source is the
+//    same, or else the zigzag-encoded distance from the source; then the weight, written by the
+//    weight serializer
+// Sources and targets are positions in the node table, so a reader never searches for a node.
+namespace gdwg {
+	namespace detail {
+		// Maps 0, -1, 1, -2, ... to 0, 1, 2, 3, ..., so small values of either sign make short
+		// varints.
+		constexpr auto zigzag(std::int64_t x) noexcept -> std::uint64_t {
+			return (static_cast<std::uint64_t>(x) << 1U) ^ (x < 0 ? ~std::uint64_t{0} : 0U);
+		}
+
+		constexpr auto unzigzag(std::uint64_t x) noexcept -> std::int64_t {
+			return static_cast<std::int64_t>((x >> 1U) ^ (0 - (x & 1U)));
+		}
+	} // namespace detail
+
+	class binary_writer {
+	public:
+		explicit binary_writer(std::ostream& os) noexcept
+		: os_{&os} {}
+
+		auto bytes(void const* data, std::size_t size) -> void {
+			os_->write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+		}
+
+		auto varint(std::uint64_t value) -> void {
+			auto buffer = std::array<unsigned char, 10>();
+			auto size = std::size_t{0};
+			for (; value >= 0x80U; value >>= 7U) {
+				buffer[size++] = static_cast<unsigned char>(value | 0x80U);
+			}
+			buffer[size++] = static_cast<unsigned char>(value);
+			bytes(buffer.data(), size);
+		}
+
+		template<typename T>
+		requires std::is_arithmetic_v<T>
+		auto fixed(T value) -> void {
+			auto buffer = std::bit_cast<std::array<std::byte, sizeof(T)>>(value);
+			if constexpr (std::endian::native == std::endian::big) {
+				std::reverse(std::begin(buffer), std::end(buffer));
+			}
+			bytes(buffer.data(), sizeof(T));
+		}
+
+	private:
+		std::ostream* os_;
+	};
+
+	// Reads from memory, such as a mapped_file, and throws std::runtime_error rather than read
+	// past the end.
+	class binary_reader {
+	public:
+		explicit binary_reader(std::span<std::byte const> data) noexcept
+		: data_{data} {}
+
+		auto bytes(std::size_t size) -> std::span<std::byte const> {
+			if (size > remaining()) {
+				corrupt();
+			}
+			auto const result = data_.subspan(position_, size);
+			position_ += size;
+			return result;
+		}
+
+		auto varint() -> std::uint64_t {
+			auto value = std::uint64_t{0};
+			for (auto shift = 0U; shift < 64U; shift += 7U) {
+				auto const byte = std::to_integer<std::uint64_t>(bytes(1)[0]);
+				value |= (byte & 0x7fU) << shift;
+				if ((byte & 0x80U) == 0) {
+					return value;
+				}
+			}
+			corrupt();
+		}
+
+		template<typename T>
+		requires std::is_arithmetic_v<T>
+		auto fixed() -> T {
+			auto buffer = std::array<std::byte, sizeof(T)>();
+			auto const in = bytes(sizeof(T));
+			std::copy(std::cbegin(in), std::cend(in), std::begin(buffer));
+			if constexpr (std::endian::native == std::endian::big) {
+				std::reverse(std::begin(buffer), std::end(buffer));
+			}
+			return std::bit_cast<T>(buffer);
+		}
+
+		[[nodiscard]] auto remaining() const noexcept -> std::size_t {
+			return std::size(data_) - position_;
+		}
+
+		[[noreturn]] static auto corrupt() -> void {
+			throw std::runtime_error("Cannot call gdwg::read_graph or gdwg::read_csr on truncated or "
+			                         "corrupt data");
+		}
+
+	private:
+		std::span<std::byte const> data_;
+		std::size_t position_ = 0;
+	};
+
+	// How nodes and weights are stored. Specialise it for other types, or pass read_graph and
+	// write_graph any object with the same write and read members. Values must come back in the
+	// same order they went out.
+	template<typename T>
+	struct binary_serializer;
+
+	// Integers are varints, zigzag-encoded when signed, so small values take one byte.
+	template<typename T>
+	requires std::is_integral_v<T>
+	struct binary_serializer<T> {
+		static auto write(binary_writer& out, T value) -> void {
+			if constexpr (std::is_signed_v<T>) {
+				out.varint(detail::zigzag(value));
+			}
+			else {
+				out.varint(value);
+			}
+		}
+
+		// A value that doesn't fit T can't have been written by write, so the data is corrupt.
+		static auto read(binary_reader& in) -> T {
+			auto const x = in.varint();
+			if constexpr (std::is_signed_v<T>) {
+				auto const value = detail::unzigzag(x);
+				if (value < std::numeric_limits<T>::min() or value > std::numeric_limits<T>::max()) {
+					binary_reader::corrupt();
+				}
+				return static_cast<T>(value);
+			}
+			else {
+				if (x > std::numeric_limits<T>::max()) {
+					binary_reader::corrupt();
+				}
+				return static_cast<T>(x);
+			}
+		}
+	};
+
+	template<typename T>
+	requires std::is_floating_point_v<T>
+	struct binary_serializer<T> {
+		static auto write(binary_writer& out, T value) -> void {
+			out.fixed(value);
+		}
+
+		static auto read(binary_reader& in) -> T {
+			return in.fixed<T>();
+		}
+	};
+
+	template<>
+	struct binary_serializer<std::string> {
+		static auto write(binary_writer& out, std::string const& value) -> void {
+			out.varint(std::size(value));
+			out.bytes(value.data(), std::size(value));
+		}
+
+		static auto read(binary_reader& in) -> std::string {
+			auto const size = in.varint();
+			if (size > in.remaining()) {
+				binary_reader::corrupt();
+			}
+			auto const data = in.bytes(static_cast<std::size_t>(size));
+			return std::string(reinterpret_cast<char const*>(data.data()), std::size(data));
+		}
+	};
+
+	// A whole file, read-only. It's mapped into memory where the platform supports it, so pages
+	// are only read as they're used, and read into a buffer otherwise.
+	class mapped_file {
+	public:
+		explicit mapped_file(std::filesystem::path const& path) {
+#if __has_include(<sys/mman.h>)
+			auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0) {
+				cannot_open(path);
+			}
+			struct ::stat status = {};
+			if (::fstat(fd, &status) != 0) {
+				::close(fd);
+				cannot_open(path);
+			}
+			size_ = static_cast<std::size_t>(status.st_size);
+			if (size_ > 0) {
+				auto* const memory = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (memory == MAP_FAILED) {
+					::close(fd);
+					cannot_open(path);
+				}
+				::madvise(memory, size_, MADV_SEQUENTIAL);
+				data_ = static_cast<std::byte const*>(memory);
+			}
+			::close(fd);
+#else
+			auto in = std::ifstream(path, std::ios::binary);
+			if (not in) {
+				cannot_open(path);
+			}
+			auto const contents = std::vector<char>(std::istreambuf_iterator<char>(in), {});
+			buffer_.resize(std::size(contents));
+			std::transform(std::cbegin(contents),
+			               std::cend(contents),
+			               std::begin(buffer_),
+			               [](char c) { return static_cast<std::byte>(c); });
+			data_ = buffer_.data();
+			size_ = std::size(buffer_);
+#endif
+		}
+
+		mapped_file(mapped_file&& other) noexcept
+		: data_{std::exchange(other.data_, nullptr)}
+		, size_{std::exchange(other.size_, 0)}
+		, buffer_{std::move(other.buffer_)} {}
+
+		mapped_file(mapped_file const&) = delete;
+		auto operator=(mapped_file const&) -> mapped_file& = delete;
+		auto operator=(mapped_file&&) -> mapped_file& = delete;
+
+		~mapped_file() {
+#if __has_include(<sys/mman.h>)
+			if (data_ != nullptr) {
+				::munmap(const_cast<std::byte*>(data_), size_);
+			}
+#endif
+		}
+
+		[[nodiscard]] auto bytes() const noexcept -> std::span<std::byte const> {
+			return {data_, size_};
+		}
+
+	private:
+		[[noreturn]] static auto cannot_open(std::filesystem::path const& path) -> void {
+			throw std::runtime_error("Cannot call gdwg::mapped_file on " + path.string()
+			                         + ", which can't be opened");
+		}
+
+		std::byte const* data_ = nullptr;
+		std::size_t size_ = 0;
+		std::vector<std::byte> buffer_;
+	};
+
+	namespace detail {
+		inline constexpr auto binary_magic = std::array<char, 4>{'G', 'D', 'W', 'G'};
+		inline constexpr auto binary_version = std::uint32_t{1};
+
+		template<typename N, typename E>
+		struct binary_contents {
+			std::vector<N> nodes;
+			// (from, to, weight) over positions in nodes, sorted and unique.
+			std::vector<std::tuple<std::size_t, std::size_t, E>> edges;
+		};
+
+		// Checks everything a graph relies on: nodes strictly ascending, and edges strictly
+		// ascending and between nodes that exist.
+		template<typename N, typename E, typename NodeSerializer, typename WeightSerializer>
+		auto decode(std::span<std::byte const> data,
+		            NodeSerializer const& node_serializer,
+		            WeightSerializer const& weight_serializer) -> binary_contents<N, E> {
+			auto in = binary_reader(data);
+			auto const magic = in.bytes(std::size(binary_magic));
+			if (not std::equal(std::cbegin(magic),
+			                   std::cend(magic),
+			                   std::cbegin(binary_magic),
+			                   [](std::byte a, char b) { return a == static_cast<std::byte>(b); })
+			    or in.fixed<std::uint32_t>() != binary_version)
+			{
+				binary_reader::corrupt();
+			}
+			auto const node_count = in.varint();
+			auto const edge_count = in.varint();
+
+			auto result = binary_contents<N, E>();
+			result.nodes.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(node_count,
+			                                                                      in.remaining())));
+			for (auto i = std::uint64_t{0}; i < node_count; ++i) {
+				result.nodes.push_back(node_serializer.read(in));
+				if (i > 0 and not(result.nodes[i - 1] < result.nodes[i])) {
+					binary_reader::corrupt();
+				}
+			}
+
+			result.edges.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(edge_count,
+			                                                                      in.remaining())));
+			auto from = std::uint64_t{0};
+			auto to = std::uint64_t{0};
+			for (auto i = std::uint64_t{0}; i < edge_count; ++i) {
+				auto const step = in.varint();
+				from += step;
+				to = step == 0 ? to + in.varint()
+				               : from + static_cast<std::uint64_t>(unzigzag(in.varint()));
+				if (from >= node_count or to >= node_count) {
+					binary_reader::corrupt();
+				}
+				auto const& edge = result.edges.emplace_back(static_cast<std::size_t>(from),
+				                                             static_cast<std::size_t>(to),
+				                                             weight_serializer.read(in));
+				if (i > 0 and not(result.edges[i - 1] < edge)) {
+					binary_reader::corrupt();
+				}
+			}
+			if (in.remaining() != 0) {
+				binary_reader::corrupt();
+			}
+			return result;
+		}
+	} // namespace detail
+
+	// Streams g to os in one pass over its nodes and one over its edges, after counting them.
+	template<concepts::regular N,
+	         concepts::regular E,
+	         typename NodeSerializer = binary_serializer<N>,
+	         typename WeightSerializer = binary_serializer<E>>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto write_graph(std::ostream& os,
+	                    graph<N, E> const& g,
+	                    NodeSerializer const& node_serializer = {},
+	                    WeightSerializer const& weight_serializer = {}) -> void {
+		auto out = binary_writer(os);
+		auto const nodes = g.nodes();
+		out.bytes(detail::binary_magic.data(), std::size(detail::binary_magic));
+		out.fixed(detail::binary_version);
+		out.varint(std::size(nodes));
+		out.varint(static_cast<std::uint64_t>(ranges::distance(g)));
+		for (auto const& x : nodes) {
+			node_serializer.write(out, x);
+		}
+
+		auto from = std::size_t{0};
+		auto previous_from = std::size_t{0};
+		auto previous_to = std::size_t{0};
+		for (auto const& e : g) {
+			while (nodes[from] != std::get<0>(e)) {
+				++from;
+			}
+			auto const to = static_cast<std::size_t>(
+			   std::lower_bound(std::cbegin(nodes), std::cend(nodes), std::get<1>(e))
+			   - std::cbegin(nodes));
+			out.varint(from - previous_from);
+			if (from == previous_from) {
+				out.varint(to - previous_to);
+			}
+			else {
+				auto const distance = static_cast<std::int64_t>(to) - static_cast<std::int64_t>(from);
+				out.varint(detail::zigzag(distance));
+			}
+			weight_serializer.write(out, std::get<2>(e));
+			previous_from = from;
+			previous_to = to;
+		}
+	}
+
+	// Builds the graph straight from the sorted node and edge tables, without searching for any
+	// node or edge. Throws std::runtime_error if data isn't a valid graph.
+	template<concepts::regular N,
+	         concepts::regular E,
+	         typename NodeSerializer = binary_serializer<N>,
+	         typename WeightSerializer = binary_serializer<E>>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto read_graph(std::span<std::byte const> data,
+	                   NodeSerializer const& node_serializer = {},
+	                   WeightSerializer const& weight_serializer = {},
+	                   std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+	      -> graph<N, E> {
+		auto contents = detail::decode<N, E>(data, node_serializer, weight_serializer);
+		auto result = graph<N, E>(resource);
+		detail::graph_access::assemble(result, contents.nodes, contents.edges);
+		return result;
+	}
+
+	// The edge table is already in CSR order, so this only counts each node's edges.
+	template<concepts::regular N,
+	         concepts::regular E,
+	         typename NodeSerializer = binary_serializer<N>,
+	         typename WeightSerializer = binary_serializer<E>>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto read_csr(std::span<std::byte const> data,
+	                 NodeSerializer const& node_serializer = {},
+	                 WeightSerializer const& weight_serializer = {}) -> csr_view<N, E> {
+		using node_id = typename csr_view<N, E>::node_id;
+		auto contents = detail::decode<N, E>(data, node_serializer, weight_serializer);
+		auto forward = typename csr_view<N, E>::adjacency();
+		forward.offsets.assign(std::size(contents.nodes) + 1, 0);
+		forward.neighbours.reserve(std::size(contents.edges));
+		forward.weights.reserve(std::size(contents.edges));
+		for (auto& [from, to, weight] : contents.edges) {
+			++forward.offsets[from + 1];
+			forward.neighbours.push_back(static_cast<node_id>(to));
+			forward.weights.push_back(std::move(weight));
+		}
+		std::partial_sum(std::cbegin(forward.offsets),
+		                 std::cend(forward.offsets),
+		                 std::begin(forward.offsets));
+		return csr_view<N, E>(std::move(contents.nodes), std::move(forward));
+	}
+
+	template<concepts::regular N,
+	         concepts::regular E,
+	         typename NodeSerializer = binary_serializer<N>,
+	         typename WeightSerializer = binary_serializer<E>>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto save_graph(std::filesystem::path const& path,
+	                   graph<N, E> const& g,
+	                   NodeSerializer const& node_serializer = {},
+	                   WeightSerializer const& weight_serializer = {}) -> void {
+		auto out = std::ofstream(path, std::ios::binary | std::ios::trunc);
+		write_graph(out, g, node_serializer, weight_serializer);
+		if (not out.flush()) {
+			throw std::runtime_error("Cannot call gdwg::save_graph on " + path.string()
+			                         + ", which can't be written");
+		}
+	}
+
+	template<concepts::regular N,
+	         concepts::regular E,
+	         typename NodeSerializer = binary_serializer<N>,
+	         typename WeightSerializer = binary_serializer<E>>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto load_graph(std::filesystem::path const& path,
+	                   NodeSerializer const& node_serializer = {},
+	                   WeightSerializer const& weight_serializer = {},
+	                   std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+	      -> graph<N, E> {
+		auto const file = mapped_file(path);
+		return read_graph<N, E>(file.bytes(), node_serializer, weight_serializer, resource);
+	}
+
+	template<concepts::regular N,
+	         concepts::regular E,
+	         typename NodeSerializer = binary_serializer<N>,
+	         typename WeightSerializer = binary_serializer<E>>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto load_csr(std::filesystem::path const& path,
+	                 NodeSerializer const& node_serializer = {},
+	                 WeightSerializer const& weight_serializer = {}) -> csr_view<N, E> {
+		auto const file = mapped_file(path);
+		return read_csr<N, E>(file.bytes(), node_serializer, weight_serializer);
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_BINARY_IO_HPP
@@ -0,0 +1,255 @@
+#ifndef GDWG_COMPONENTS_HPP
+#define GDWG_COMPONENTS_HPP
+
+#include "gdwg/csr_view.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// The strongly connected components of a csr_view. Components are numbered in topological
+	// order: every edge between two components goes from a lower number to a higher one. It
+	// refers to the view it was computed on, which must outlive it.
+	template<concepts::regular N, concepts::regular E>
+	class strong_components {
+	public:
+		using node_id = typename csr_view<N, E>::node_id;
+
+		strong_components(csr_view<N, E> const& view,
+		                  std::vector<node_id> components,
+		                  std::size_t count)
+		: view_{&view}
+		, components_{std::move(components)}
+		, offsets_(count + 1, 0)
+		, members_(std::size(components_)) {
+			for (auto const c : components_) {
+				++offsets_[c + 1];
+			}
+			std::partial_sum(std::cbegin(offsets_), std::cend(offsets_), std::begin(offsets_));
+			auto next =
+			   std::vector<std::size_t>(std::cbegin(offsets_), std::prev(std::cend(offsets_)));
+			for (auto id = node_id{0}; id < view.node_count(); ++id) {
+				members_[next[components_[id]]++] = id;
+			}
+		}
+
+		[[nodiscard]] auto count() const noexcept -> std::size_t {
+			return std::size(offsets_) - 1;
+		}
+
+		[[nodiscard]] auto component(N const& value) const -> node_id {
+			return components_[view_->id(value)];
+		}
+
+		// The nodes of component c, in value order.
+		[[nodiscard]] auto members(node_id c) const -> std::vector<N> {
+			auto result = std::vector<N>();
+			result.reserve(offsets_[c + 1] - offsets_[c]);
+			for (auto i = offsets_[c]; i < offsets_[c + 1]; ++i) {
+				result.push_back(view_->node(members_[i]));
+			}
+			return result;
+		}
+
+		// The component of each node, indexed by the csr_view's node IDs.
+		[[nodiscard]] auto components() const noexcept -> std::span<node_id const> {
+			return components_;
+		}
+
+		// The condensation DAG: one node per component and one edge between each pair of
+		// components that any original edge joins, weighted by the number of such edges.
+		[[nodiscard]] auto condensation() const -> graph<node_id, std::size_t> {
+			auto const& out = view_->forward();
+			auto links = std::vector<std::pair<node_id, node_id>>();
+			for (auto u = node_id{0}; u < view_->node_count(); ++u) {
+				for (auto const v : out.neighbours_of(u)) {
+					if (components_[u] != components_[v]) {
+						links.emplace_back(components_[u], components_[v]);
+					}
+				}
+			}
+			std::sort(std::begin(links), std::end(links));
+
+			auto result = graph<node_id, std::size_t>();
+			for (auto c = node_id{0}; c < count(); ++c) {
+				result.insert_node(c);
+			}
+			for (auto first = std::cbegin(links); first != std::cend(links);) {
+				auto const last = std::find_if(first, std::cend(links), [first](auto const& link) {
+					return link != *first;
+				});
+				result.insert_edge(first->first,
+				                   first->second,
+				                   static_cast<std::size_t>(last - first));
+				first = last;
+			}
+			return result;
+		}
+
+	private:
+		csr_view<N, E> const* view_;
+		std::vector<node_id> components_;
+		std::vector<std::size_t> offsets_;
+		std::vector<node_id> members_;
+	};
+
+	// Tarjan's algorithm, with the recursion replaced by an explicit stack of (node, next edge)
+	// frames so that long paths can't overflow the call stack. Linear in nodes plus edges.
+	template<concepts::regular N, concepts::regular E>
+	auto strongly_connected_components(csr_view<N, E> const& g) -> strong_components<N, E> {
+		using node_id = typename csr_view<N, E>::node_id;
+		constexpr auto unvisited = std::numeric_limits<node_id>::max();
+
+		auto const n = g.node_count();
+		auto const& out = g.forward();
+		auto index = std::vector<node_id>(n, unvisited);
+		auto low = std::vector<node_id>(n);
+		auto on_stack = std::vector<bool>(n);
+		auto stack = std::vector<node_id>();
+		auto frames = std::vector<std::pair<node_id, std::size_t>>();
+		auto components = std::vector<node_id>(n);
+		auto next_index = node_id{0};
+		auto count = node_id{0};
+
+		auto const visit = [&](node_id u) {
+			index[u] = low[u] = next_index++;
+			stack.push_back(u);
+			on_stack[u] = true;
+			frames.emplace_back(u, out.offsets[u]);
+		};
+
+		for (auto root = node_id{0}; root < n; ++root) {
+			if (index[root] != unvisited) {
+				continue;
+			}
+			visit(root);
+			while (not frames.empty()) {
+				auto const u = frames.back().first;
+				auto& e = frames.back().second;
+				if (e < out.offsets[u + 1]) {
+					auto const v = out.neighbours[e++];
+					if (index[v] == unvisited) {
+						visit(v);
+					}
+					else if (on_stack[v]) {
+						low[u] = std::min(low[u], index[v]);
+					}
+					continue;
+				}
+
+				frames.pop_back();
+				if (not frames.empty()) {
+					auto const parent = frames.back().first;
+					low[parent] = std::min(low[parent], low[u]);
+				}
+				if (low[u] == index[u]) {
+					auto member = unvisited;
+					do {
+						member = stack.back();
+						stack.pop_back();
+						on_stack[member] = false;
+						components[member] = count;
+					} while (member != u);
+					++count;
+				}
+			}
+		}
+
+		// Tarjan finishes each component after every component it can reach, so reversing the
+		// numbering puts them in topological order.
+		for (auto& c : components) {
+			c = count - 1 - c;
+		}
+		return strong_components<N, E>(g, std::move(components), count);
+	}
+
+	template<concepts::regular N>
+	struct topological_sort_result {
+		// Every node, with each edge's source before its target. Empty if the graph has a cycle.
+		std::vector<N> order;
+		// If the graph isn't acyclic, the nodes of one cycle in edge order, starting from its
+		// smallest node. The last node has an edge back to the first.
+		std::vector<N> cycle;
+
+		[[nodiscard]] auto acyclic() const noexcept -> bool {
+			return cycle.empty();
+		}
+	};
+
+	// Kahn's algorithm. Nodes come out in the order they become ready, starting from the nodes
+	// without incoming edges in value order, so the result is deterministic. A self loop counts as
+	// a cycle.
+	template<concepts::regular N, concepts::regular E>
+	auto topological_sort(csr_view<N, E> const& g) -> topological_sort_result<N> {
+		using node_id = typename csr_view<N, E>::node_id;
+		auto const n = g.node_count();
+		auto const& out = g.forward();
+		auto const& in = g.reverse();
+
+		auto waiting = std::vector<std::size_t>(n);
+		auto ready = std::vector<node_id>();
+		ready.reserve(n);
+		for (auto v = node_id{0}; v < n; ++v) {
+			waiting[v] = in.degree(v);
+			if (waiting[v] == 0) {
+				ready.push_back(v);
+			}
+		}
+		for (auto i = std::size_t{0}; i < std::size(ready); ++i) {
+			for (auto const v : out.neighbours_of(ready[i])) {
+				if (--waiting[v] == 0) {
+					ready.push_back(v);
+				}
+			}
+		}
+
+		auto result = topological_sort_result<N>();
+		if (std::size(ready) == n) {
+			result.order.reserve(n);
+			for (auto const v : ready) {
+				result.order.push_back(g.node(v));
+			}
+			return result;
+		}
+
+		// Every node left over still waits on a left-over predecessor, so walking backwards
+		// through them must come round to a node already seen.
+		constexpr auto unseen = std::numeric_limits<std::size_t>::max();
+		auto seen_at = std::vector<std::size_t>(n, unseen);
+		auto walk = std::vector<node_id>();
+		auto v = node_id{0};
+		while (waiting[v] == 0) {
+			++v;
+		}
+		while (seen_at[v] == unseen) {
+			seen_at[v] = std::size(walk);
+			walk.push_back(v);
+			auto const predecessors = in.neighbours_of(v);
+			v = *std::find_if(std::cbegin(predecessors), std::cend(predecessors), [&](node_id u) {
+				return waiting[u] != 0;
+			});
+		}
+		auto cycle = std::vector<node_id>(
+		   std::next(std::cbegin(walk), static_cast<std::ptrdiff_t>(seen_at[v])),
+		   std::cend(walk));
+		std::reverse(std::begin(cycle), std::end(cycle));
+		std::rotate(std::begin(cycle),
+		            std::min_element(std::begin(cycle), std::end(cycle)),
+		            std::end(cycle));
+		for (auto const u : cycle) {
+			result.cycle.push_back(g.node(u));
+		}
+		return result;
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_COMPONENTS_HPP
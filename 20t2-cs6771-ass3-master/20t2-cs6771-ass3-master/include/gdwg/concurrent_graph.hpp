@@ -0,0 +1,296 @@
+#ifndef GDWG_CONCURRENT_GRAPH_HPP
+#define GDWG_CONCURRENT_GRAPH_HPP
+
+#include "gdwg/detail/persistent_adjacency.hpp"
+#include "gdwg/detail/persistent_map.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// A graph that any number of threads can read and write at once. Nodes are spread over shards
+	// by hash, and each shard holds an immutable persistent map of its nodes and their edges.
+	// Readers copy the current map's pointer in a fixed number of atomic operations and work on
+	// that version, so they never wait for a writer. Writers lock only the shards they change,
+	// build the next version and publish it, waiting if need be for readers still copying an older
+	// pointer. A read that touches one node sees a single version of that node's shard. Operations
+	// that span shards, such as nodes() or erase_node(), aren't atomic with respect to readers.
+	template<concepts::regular N, concepts::regular E, typename Hash = std::hash<N>>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   class concurrent_graph {
+	public:
+		static constexpr auto default_shards = std::size_t{64};
+
+		explicit concurrent_graph(std::size_t shards = default_shards)
+		: shard_count_{std::max(shards, std::size_t{1})}
+		, shards_{std::make_unique<shard[]>(shard_count_)} {}
+
+		concurrent_graph(concurrent_graph const&) = delete;
+		auto operator=(concurrent_graph const&) -> concurrent_graph& = delete;
+
+		[[nodiscard]] auto is_node(N const& value) const -> bool {
+			return load(value)->contains(value);
+		}
+
+		[[nodiscard]] auto empty() const -> bool {
+			return std::all_of(shards_.get(), shards_.get() + shard_count_, [](shard const& s) {
+				return s.load()->empty();
+			});
+		}
+
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			auto const nodes = load(src);
+			if (auto const* a = nodes->find(src); a != nullptr and is_node(dst)) {
+				return a->out.contains(dst);
+			}
+			throw std::runtime_error("Cannot call gdwg::concurrent_graph<N, E>::is_connected if src "
+			                         "or dst node don't exist in the graph");
+		}
+
+		// In value order. Each shard is read at a different moment.
+		[[nodiscard]] auto nodes() const -> std::vector<N> {
+			auto result = std::vector<N>();
+			for (auto i = std::size_t{0}; i < shard_count_; ++i) {
+				auto const nodes = shards_[i].load();
+				for (auto const& x : *nodes) {
+					result.push_back(x.key);
+				}
+			}
+			std::sort(std::begin(result), std::end(result));
+			return result;
+		}
+
+		[[nodiscard]] auto weights(N const& src, N const& dst) const -> std::vector<E> {
+			auto const nodes = load(src);
+			if (auto const* a = nodes->find(src); a != nullptr and is_node(dst)) {
+				return adjacency::weights(a->out, dst);
+			}
+			throw std::runtime_error("Cannot call gdwg::concurrent_graph<N, E>::weights if src or "
+			                         "dst node don't exist in the graph");
+		}
+
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+			auto const nodes = load(src);
+			if (auto const* a = nodes->find(src)) {
+				return adjacency::neighbours(a->out);
+			}
+			throw std::runtime_error("Cannot call gdwg::concurrent_graph<N, E>::connections if src "
+			                         "doesn't exist in the graph");
+		}
+
+		[[nodiscard]] auto connections_to(N const& dst) const -> std::vector<N> {
+			auto const nodes = load(dst);
+			if (auto const* a = nodes->find(dst)) {
+				return adjacency::neighbours(a->in);
+			}
+			throw std::runtime_error("Cannot call gdwg::concurrent_graph<N, E>::connections_to if "
+			                         "dst doesn't exist in the graph");
+		}
+
+		// A regular graph holding one consistent version of every shard. Blocks writers while it
+		// reads.
+		[[nodiscard]] auto to_graph() const -> graph<N, E> {
+			auto const locks = lock_all();
+			auto edges = std::vector<typename graph<N, E>::value_type>();
+			auto values = std::vector<N>();
+			for (auto i = std::size_t{0}; i < shard_count_; ++i) {
+				auto const nodes = shards_[i].load();
+				for (auto const& [from, a] : *nodes) {
+					values.push_back(from);
+					for (auto const& [to, weights] : a.out) {
+						for (auto const& w : weights) {
+							edges.push_back({from, to, w.key});
+						}
+					}
+				}
+			}
+			auto result = graph<N, E>(std::cbegin(edges), std::cend(edges));
+			result.insert_nodes(std::cbegin(values), std::cend(values));
+			return result;
+		}
+
+		auto insert_node(N const& value) -> bool {
+			auto& s = shard_of(value);
+			auto const lock = std::scoped_lock(s.write);
+			auto const nodes = s.load();
+			if (nodes->contains(value)) {
+				return false;
+			}
+			publish(s, nodes->insert_or_assign(value, adjacency{}));
+			return true;
+		}
+
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			auto const locks = lock_pair(src, dst);
+			if (not is_node(src) or not is_node(dst)) {
+				throw std::runtime_error("Cannot call gdwg::concurrent_graph<N, E>::insert_edge when "
+				                         "either src or dst node does not exist");
+			}
+			if (adjacency::contains(load(src)->at(src).out, dst, weight)) {
+				return false;
+			}
+			update(src, dst, weight, true);
+			return true;
+		}
+
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			auto const locks = lock_pair(src, dst);
+			if (not is_node(src) or not is_node(dst)) {
+				throw std::runtime_error("Cannot call gdwg::concurrent_graph<N, E>::erase_edge on src "
+				                         "or dst if they don't exist in the graph");
+			}
+			if (not adjacency::contains(load(src)->at(src).out, dst, weight)) {
+				return false;
+			}
+			update(src, dst, weight, false);
+			return true;
+		}
+
+		// Locks every shard, since the node's neighbours can be anywhere. Edges are removed from
+		// the neighbours before the node itself.
+		auto erase_node(N const& value) -> bool {
+			auto const locks = lock_all();
+			auto& home = shard_of(value);
+			auto const before = home.load();
+			auto const* found = before->find(value);
+			if (found == nullptr) {
+				return false;
+			}
+			auto const removed = *found;
+			for (auto const& x : removed.out) {
+				if (x.key != value) {
+					modify(x.key, [&value](adjacency& a) { a.in = a.in.erase(value); });
+				}
+			}
+			for (auto const& x : removed.in) {
+				if (x.key != value) {
+					modify(x.key, [&value](adjacency& a) { a.out = a.out.erase(value); });
+				}
+			}
+			publish(home, home.load()->erase(value));
+			return true;
+		}
+
+		auto clear() -> void {
+			auto const locks = lock_all();
+			for (auto i = std::size_t{0}; i < shard_count_; ++i) {
+				publish(shards_[i], node_map());
+			}
+		}
+
+	private:
+		using adjacency = detail::persistent_adjacency<N, E>;
+		using node_map = detail::persistent_map<N, adjacency>;
+
+		// The current version sits in one of two slots, named by the lowest bit of state. A reader
+		// adds 2 to state, which both picks the slot and counts the reader in, copies the slot's
+		// pointer and leaves by decrementing the slot's readers. publish() hands the count in state
+		// over to the slot it retires, so readers reaches 0 once all of them have left.
+		struct shard {
+			struct slot {
+				std::shared_ptr<node_map const> nodes;
+				std::atomic<std::int64_t> readers = 0;
+			};
+
+			[[nodiscard]] auto load() const -> std::shared_ptr<node_map const> {
+				auto const entered = state.fetch_add(2, std::memory_order_acquire);
+				auto& current = slots[entered & 1U];
+				auto nodes = current.nodes;
+				current.readers.fetch_sub(1, std::memory_order_release);
+				return nodes;
+			}
+
+			// Serialises writers. Readers never take it.
+			std::mutex write;
+			mutable std::atomic<std::uint64_t> state = 0;
+			mutable std::array<slot, 2> slots = {slot{std::make_shared<node_map const>()}, slot{}};
+		};
+
+		[[nodiscard]] auto index(N const& value) const -> std::size_t {
+			return Hash()(value) % shard_count_;
+		}
+
+		[[nodiscard]] auto shard_of(N const& value) const -> shard& {
+			return shards_[index(value)];
+		}
+
+		[[nodiscard]] auto load(N const& value) const -> std::shared_ptr<node_map const> {
+			return shard_of(value).load();
+		}
+
+		// Fills the slot that isn't current and switches readers to it. That slot still holds the
+		// version before last, so the writer first waits for any reader still copying it. The
+		// caller holds the shard's lock.
+		static auto publish(shard& s, node_map nodes) -> void {
+			auto next = std::make_shared<node_map const>(std::move(nodes));
+			auto const current = s.state.load(std::memory_order_relaxed) & 1U;
+			auto& spare = s.slots[current ^ 1U];
+			while (spare.readers.load(std::memory_order_acquire) != 0) {
+				std::this_thread::yield();
+			}
+			spare.nodes = std::move(next);
+			auto const before = s.state.exchange(current ^ 1U, std::memory_order_acq_rel);
+			s.slots[current].readers.fetch_add(static_cast<std::int64_t>(before >> 1U),
+			                                   std::memory_order_relaxed);
+		}
+
+		// Replaces the adjacency of value with f applied to a copy of it. The caller holds the lock
+		// of value's shard.
+		template<typename F>
+		auto modify(N const& value, F const& f) -> void {
+			auto& s = shard_of(value);
+			auto const nodes = s.load();
+			auto a = nodes->at(value);
+			f(a);
+			publish(s, nodes->insert_or_assign(value, std::move(a)));
+		}
+
+		// The target's incoming edges change first, so a reader that finds an edge from src can
+		// already find it from dst.
+		auto update(N const& src, N const& dst, E const& weight, bool add) -> void {
+			modify(dst, [&](adjacency& a) { a.in = adjacency::toggle(a.in, src, weight, add); });
+			modify(src, [&](adjacency& a) { a.out = adjacency::toggle(a.out, dst, weight, add); });
+		}
+
+		// Shards are always locked in index order, so writers can't deadlock.
+		[[nodiscard]] auto lock_pair(N const& a, N const& b) const
+		   -> std::pair<std::unique_lock<std::mutex>, std::unique_lock<std::mutex>> {
+			auto const i = index(a);
+			auto const j = index(b);
+			auto first = std::unique_lock(shards_[std::min(i, j)].write);
+			if (i == j) {
+				return {std::move(first), std::unique_lock<std::mutex>()};
+			}
+			return {std::move(first), std::unique_lock(shards_[std::max(i, j)].write)};
+		}
+
+		[[nodiscard]] auto lock_all() const -> std::vector<std::unique_lock<std::mutex>> {
+			auto locks = std::vector<std::unique_lock<std::mutex>>();
+			locks.reserve(shard_count_);
+			for (auto i = std::size_t{0}; i < shard_count_; ++i) {
+				locks.emplace_back(shards_[i].write);
+			}
+			return locks;
+		}
+
+		std::size_t shard_count_;
+		std::unique_ptr<shard[]> shards_;
+	};
+
+} // namespace gdwg
+
+#endif // GDWG_CONCURRENT_GRAPH_HPP
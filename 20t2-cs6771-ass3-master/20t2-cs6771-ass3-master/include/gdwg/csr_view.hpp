@@ -0,0 +1,315 @@
+#ifndef GDWG_CSR_VIEW_HPP
+#define GDWG_CSR_VIEW_HPP
+
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <range/v3/utility.hpp>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// An immutable compressed-sparse-row copy of a graph. Nodes get dense IDs in value order, so
+	// ID order, CSR order and graph::iterator order all agree. Each direction stores an offsets
+	// array with node_count() + 1 entries and parallel neighbour and weight arrays, where the
+	// edges of node i are [offsets[i], offsets[i + 1]), sorted by (neighbour, weight).
+	template<concepts::regular N, concepts::regular E>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   class csr_view {
+	public:
+		using node_id = std::uint32_t;
+		class iterator;
+
+		struct adjacency {
+			std::vector<std::size_t> offsets;
+			std::vector<node_id> neighbours;
+			std::vector<E> weights;
+
+			[[nodiscard]] auto degree(node_id id) const noexcept -> std::size_t {
+				return offsets[id + 1] - offsets[id];
+			}
+
+			[[nodiscard]] auto neighbours_of(node_id id) const noexcept -> std::span<node_id const> {
+				return std::span<node_id const>(neighbours).subspan(offsets[id], degree(id));
+			}
+
+			[[nodiscard]] auto weights_of(node_id id) const noexcept -> std::span<E const> {
+				return std::span<E const>(weights).subspan(offsets[id], degree(id));
+			}
+		};
+
+		csr_view() = default;
+
+		explicit csr_view(graph<N, E> const& g)
+		: nodes_{g.nodes()} {
+			check_node_count();
+			forward_.offsets.assign(std::size(nodes_) + 1, 0);
+			for (auto const& e : g) {
+				++forward_.offsets[id(std::get<0>(e)) + 1];
+				forward_.neighbours.push_back(id(std::get<1>(e)));
+				forward_.weights.push_back(std::get<2>(e));
+			}
+			std::partial_sum(std::cbegin(forward_.offsets),
+			                 std::cend(forward_.offsets),
+			                 std::begin(forward_.offsets));
+			index_reverse();
+		}
+
+		// Adopts outgoing edges already in CSR form. nodes must be sorted and unique, and each row
+		// of forward sorted by (neighbour, weight), as forward() returns them.
+		csr_view(std::vector<N> nodes, adjacency forward)
+		: nodes_{std::move(nodes)}
+		, forward_{std::move(forward)} {
+			check_node_count();
+			index_reverse();
+		}
+
+		[[nodiscard]] auto node_count() const noexcept -> node_id {
+			return static_cast<node_id>(std::size(nodes_));
+		}
+
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t {
+			return std::size(forward_.neighbours);
+		}
+
+		[[nodiscard]] auto node(node_id id) const noexcept -> N const& {
+			return nodes_[id];
+		}
+
+		[[nodiscard]] auto nodes() const noexcept -> std::span<N const> {
+			return nodes_;
+		}
+
+		[[nodiscard]] auto id(N const& value) const -> node_id {
+			auto const it = std::lower_bound(std::cbegin(nodes_), std::cend(nodes_), value);
+			if (it == std::cend(nodes_) or *it != value) {
+				throw std::runtime_error("Cannot call gdwg::csr_view<N, E>::id on a node that doesn't "
+				                         "exist");
+			}
+			return static_cast<node_id>(it - std::cbegin(nodes_));
+		}
+
+		// Outgoing edges, ordered by (source, target, weight).
+		[[nodiscard]] auto forward() const noexcept -> adjacency const& {
+			return forward_;
+		}
+
+		// Incoming edges, ordered by (target, source, weight).
+		[[nodiscard]] auto reverse() const noexcept -> adjacency const& {
+			return reverse_;
+		}
+
+		[[nodiscard]] auto is_node(N const& value) const -> bool {
+			return std::binary_search(std::cbegin(nodes_), std::cend(nodes_), value);
+		}
+
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return nodes_.empty();
+		}
+
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			if (is_node(src) and is_node(dst)) {
+				auto const row = forward_.neighbours_of(id(src));
+				return std::binary_search(std::cbegin(row), std::cend(row), id(dst));
+			}
+			throw std::runtime_error("Cannot call gdwg::csr_view<N, E>::is_connected if src or dst "
+			                         "node don't exist in the graph");
+		}
+
+		[[nodiscard]] auto weights(N const& src, N const& dst) const -> std::vector<E> {
+			if (is_node(src) and is_node(dst)) {
+				auto const [first, last] = edge_range(id(src), id(dst));
+				return std::vector<E>(std::next(std::cbegin(forward_.weights), diff(first)),
+				                      std::next(std::cbegin(forward_.weights), diff(last)));
+			}
+			throw std::runtime_error("Cannot call gdwg::csr_view<N, E>::weights if src or dst node "
+			                         "don't exist in the graph");
+		}
+
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+			if (is_node(src)) {
+				return materialise(forward_.neighbours_of(id(src)));
+			}
+			throw std::runtime_error("Cannot call gdwg::csr_view<N, E>::connections if src doesn't "
+			                         "exist in the graph");
+		}
+
+		[[nodiscard]] auto connections_to(N const& dst) const -> std::vector<N> {
+			if (is_node(dst)) {
+				return materialise(reverse_.neighbours_of(id(dst)));
+			}
+			throw std::runtime_error("Cannot call gdwg::csr_view<N, E>::connections_to if dst doesn't "
+			                         "exist in the graph");
+		}
+
+		[[nodiscard]] auto find(N const& src, N const& dst, E const& weight) const -> iterator {
+			if (not is_node(src) or not is_node(dst)) {
+				return end();
+			}
+			auto const source = id(src);
+			auto const [first, last] = edge_range(source, id(dst));
+			auto const w = std::lower_bound(std::next(std::cbegin(forward_.weights), diff(first)),
+			                                std::next(std::cbegin(forward_.weights), diff(last)),
+			                                weight);
+			if (w == std::next(std::cbegin(forward_.weights), diff(last)) or *w != weight) {
+				return end();
+			}
+			return iterator(this, static_cast<std::size_t>(w - std::cbegin(forward_.weights)), source);
+		}
+
+		[[nodiscard]] auto begin() const -> iterator {
+			return iterator(this, 0, 0);
+		}
+
+		[[nodiscard]] auto end() const -> iterator {
+			return iterator(this, edge_count(), node_count());
+		}
+
+	private:
+		auto check_node_count() const -> void {
+			if (std::size(nodes_) >= std::numeric_limits<node_id>::max()) {
+				throw std::runtime_error("Cannot call gdwg::freeze on a graph with more than 2^32 - 2 "
+				                         "nodes");
+			}
+		}
+
+		// Sources are visited in ascending order, so each reverse row comes out sorted by
+		// (source, weight) without a separate sort.
+		auto index_reverse() -> void {
+			reverse_.offsets.assign(std::size(nodes_) + 1, 0);
+			for (auto const dst : forward_.neighbours) {
+				++reverse_.offsets[dst + 1];
+			}
+			std::partial_sum(std::cbegin(reverse_.offsets),
+			                 std::cend(reverse_.offsets),
+			                 std::begin(reverse_.offsets));
+			reverse_.neighbours.resize(std::size(forward_.neighbours));
+			reverse_.weights.resize(std::size(forward_.weights));
+			auto next = std::vector<std::size_t>(std::cbegin(reverse_.offsets),
+			                                     std::prev(std::cend(reverse_.offsets)));
+			for (auto src = node_id{0}; src < node_count(); ++src) {
+				for (auto e = forward_.offsets[src]; e < forward_.offsets[src + 1]; ++e) {
+					auto const slot = next[forward_.neighbours[e]]++;
+					reverse_.neighbours[slot] = src;
+					reverse_.weights[slot] = forward_.weights[e];
+				}
+			}
+		}
+
+		[[nodiscard]] static auto diff(std::size_t i) noexcept -> std::ptrdiff_t {
+			return static_cast<std::ptrdiff_t>(i);
+		}
+
+		// The positions in the forward arrays of every edge from src to dst.
+		[[nodiscard]] auto edge_range(node_id src, node_id dst) const noexcept
+		   -> std::pair<std::size_t, std::size_t> {
+			auto const row = forward_.neighbours_of(src);
+			auto const [first, last] = std::equal_range(std::cbegin(row), std::cend(row), dst);
+			auto const base = forward_.offsets[src];
+			return {base + static_cast<std::size_t>(first - std::cbegin(row)),
+			        base + static_cast<std::size_t>(last - std::cbegin(row))};
+		}
+
+		[[nodiscard]] auto materialise(std::span<node_id const> ids) const -> std::vector<N> {
+			auto result = std::vector<N>();
+			result.reserve(std::size(ids));
+			std::transform(std::cbegin(ids),
+			               std::cend(ids),
+			               std::back_inserter(result),
+			               [this](node_id i) { return nodes_[i]; });
+			return result;
+		}
+
+		std::vector<N> nodes_;
+		adjacency forward_;
+		adjacency reverse_;
+
+	public:
+		// Visits the same (from, to, weight) tuples in the same order as graph::iterator.
+		class iterator {
+		public:
+			using value_type = ranges::common_tuple<N, N, E>;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::bidirectional_iterator_tag;
+
+			iterator() = default;
+
+			auto operator*() const -> ranges::common_tuple<N const&, N const&, E const&> {
+				return ranges::common_tuple<N const&, N const&, E const&>(
+				   view_->nodes_[source_],
+				   view_->nodes_[view_->forward_.neighbours[edge_]],
+				   view_->forward_.weights[edge_]);
+			}
+
+			auto operator++() -> iterator& {
+				++edge_;
+				skip_forward();
+				return *this;
+			}
+			auto operator++(int) -> iterator {
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			auto operator--() -> iterator& {
+				--edge_;
+				while (view_->forward_.offsets[source_] > edge_) {
+					--source_;
+				}
+				return *this;
+			}
+			auto operator--(int) -> iterator {
+				auto tmp = *this;
+				--*this;
+				return tmp;
+			}
+
+			auto operator==(iterator const& other) const noexcept -> bool {
+				return view_ == other.view_ and edge_ == other.edge_;
+			}
+
+		private:
+			friend class csr_view<N, E>;
+
+			iterator(csr_view const* view, std::size_t edge, node_id source)
+			: view_{view}
+			, edge_{edge}
+			, source_{source} {
+				skip_forward();
+			}
+
+			// Moves source_ past nodes whose edges all come before edge_.
+			auto skip_forward() noexcept -> void {
+				auto const& offsets = view_->forward_.offsets;
+				while (source_ < view_->node_count() and offsets[source_ + 1] <= edge_) {
+					++source_;
+				}
+			}
+
+			csr_view const* view_ = nullptr;
+			std::size_t edge_ = 0;
+			node_id source_ = 0;
+		};
+	};
+
+	template<concepts::regular N, concepts::regular E>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto freeze(graph<N, E> const& g) -> csr_view<N, E> {
+		return csr_view<N, E>(g);
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_CSR_VIEW_HPP
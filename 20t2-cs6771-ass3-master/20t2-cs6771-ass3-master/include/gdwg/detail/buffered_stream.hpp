@@ -0,0 +1,102 @@
+#ifndef GDWG_DETAIL_BUFFERED_STREAM_HPP
+#define GDWG_DETAIL_BUFFERED_STREAM_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+namespace gdwg::detail {
+
+	// A stream with the formatting state of os that collects its output in a buffer and passes it
+	// on with one os.write per buffer-full. Writing straight to a stream such as std::cout, which
+	// is synchronised with stdio, costs a virtual call or more per character. size_hint estimates
+	// the bytes to be written: output shorter than direct_size goes straight to os, and longer
+	// output gets a buffer of at most buffer_size. Output still in the buffer is dropped unless
+	// finish() is called.
+	class buffered_stream {
+	public:
+		static constexpr auto buffer_size = std::size_t{1} << 16U;
+		static constexpr auto direct_size = std::size_t{1} << 10U;
+
+		buffered_stream(std::ostream& os, std::size_t size_hint)
+		: os_{&os} {
+			if (size_hint >= direct_size) {
+				buffered_.emplace(os, std::min(size_hint, buffer_size));
+			}
+		}
+
+		buffered_stream(buffered_stream const&) = delete;
+		auto operator=(buffered_stream const&) -> buffered_stream& = delete;
+
+		[[nodiscard]] auto stream() noexcept -> std::ostream& {
+			return buffered_ ? buffered_->stream : *os_;
+		}
+
+		auto finish() -> void {
+			if (buffered_) {
+				buffered_->stream.flush();
+			}
+		}
+
+	private:
+		class buffer : public std::streambuf {
+		public:
+			buffer(std::ostream& os, std::size_t size)
+			: os_{&os}
+			, data_(size) {
+				reset();
+			}
+
+		protected:
+			auto overflow(int_type c) -> int_type override {
+				drain();
+				if (not traits_type::eq_int_type(c, traits_type::eof())) {
+					*pptr() = traits_type::to_char_type(c);
+					pbump(1);
+				}
+				return os_->good() ? traits_type::not_eof(c) : traits_type::eof();
+			}
+
+			auto sync() -> int override {
+				drain();
+				return os_->good() ? 0 : -1;
+			}
+
+		private:
+			auto drain() -> void {
+				os_->write(pbase(), pptr() - pbase());
+				reset();
+			}
+
+			auto reset() -> void {
+				setp(data_.data(), data_.data() + std::size(data_));
+			}
+
+			std::ostream* os_;
+			std::vector<char> data_;
+		};
+
+		// The width applies to the first thing written, as it would have on os, and not to
+		// whatever os is given after the buffered output.
+		struct buffered {
+			buffered(std::ostream& os, std::size_t size)
+			: buf{os, size}
+			, stream{&buf} {
+				stream.copyfmt(os);
+				os.width(0);
+			}
+
+			buffer buf;
+			std::ostream stream;
+		};
+
+		std::ostream* os_;
+		std::optional<buffered> buffered_;
+	};
+
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_BUFFERED_STREAM_HPP
@@ -0,0 +1,79 @@
+#ifndef GDWG_DETAIL_DARY_HEAP_HPP
+#define GDWG_DETAIL_DARY_HEAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace gdwg::detail {
+
+	// A min-heap whose nodes have Arity children. A wider node makes the heap shallower, and the
+	// children compared on each step of a sift-down sit next to each other in memory.
+	template<typename T, std::size_t Arity = 4, typename Compare = std::less<>>
+	class dary_heap {
+	public:
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return data_.empty();
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return data_.size();
+		}
+
+		[[nodiscard]] auto top() const noexcept -> T const& {
+			return data_.front();
+		}
+
+		auto push(T value) -> void {
+			auto i = data_.size();
+			data_.push_back(std::move(value));
+			while (i > 0) {
+				auto const parent = (i - 1) / Arity;
+				if (not compare_(data_[i], data_[parent])) {
+					break;
+				}
+				std::swap(data_[i], data_[parent]);
+				i = parent;
+			}
+		}
+
+		auto pop() -> void {
+			if (data_.size() > 1) {
+				data_.front() = std::move(data_.back());
+			}
+			data_.pop_back();
+			auto i = std::size_t{0};
+			while (true) {
+				auto const first_child = i * Arity + 1;
+				if (first_child >= data_.size()) {
+					break;
+				}
+				auto const last_child = std::min(first_child + Arity, data_.size());
+				auto smallest = first_child;
+				for (auto c = first_child + 1; c < last_child; ++c) {
+					if (compare_(data_[c], data_[smallest])) {
+						smallest = c;
+					}
+				}
+				if (not compare_(data_[smallest], data_[i])) {
+					break;
+				}
+				std::swap(data_[i], data_[smallest]);
+				i = smallest;
+			}
+		}
+
+		auto clear() noexcept -> void {
+			data_.clear();
+		}
+
+	private:
+		std::vector<T> data_;
+		[[no_unique_address]] Compare compare_;
+	};
+
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_DARY_HEAP_HPP
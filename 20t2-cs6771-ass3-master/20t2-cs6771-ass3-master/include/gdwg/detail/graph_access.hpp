@@ -0,0 +1,39 @@
+#ifndef GDWG_DETAIL_GRAPH_ACCESS_HPP
+#define GDWG_DETAIL_GRAPH_ACCESS_HPP
+
+#include "gdwg/graph.hpp"
+
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+namespace gdwg::detail {
+
+	// Lets the loaders and exporters work on a graph's storage directly.
+	struct graph_access {
+		// Fills an empty graph from sorted, unique node values and sorted, unique (from, to,
+		// weight) keys over positions in values.
+		template<typename N, typename E>
+		static auto assemble(graph<N, E>& g,
+		                     std::vector<N>& values,
+		                     std::vector<std::tuple<std::size_t, std::size_t, E>> const& keys)
+		   -> void {
+			g.assemble(values, keys);
+		}
+
+		// In value order.
+		template<typename N, typename E>
+		[[nodiscard]] static auto nodes(graph<N, E> const& g) noexcept -> auto const& {
+			return g.nodes_;
+		}
+
+		// In (from, to, weight) order. Each edge's from and to point into nodes(g).
+		template<typename N, typename E>
+		[[nodiscard]] static auto edges(graph<N, E> const& g) noexcept -> auto const& {
+			return g.edges_;
+		}
+	};
+
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_GRAPH_ACCESS_HPP
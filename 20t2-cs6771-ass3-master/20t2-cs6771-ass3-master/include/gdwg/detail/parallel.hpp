@@ -0,0 +1,87 @@
+#ifndef GDWG_DETAIL_PARALLEL_HPP
+#define GDWG_DETAIL_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gdwg::detail {
+
+	inline auto default_threads() noexcept -> unsigned {
+		return std::max(std::thread::hardware_concurrency(), 1U);
+	}
+
+	// Splits [0, count) into one contiguous block per thread and calls f(first, last, thread) for
+	// each block. The calling thread takes block 0. Runs inline when there is too little work to be
+	// worth starting threads for.
+	template<typename F>
+	auto parallel_for(unsigned threads, std::size_t count, F const& f) -> void {
+		constexpr auto grain = std::size_t{1024};
+		auto const max_blocks = static_cast<std::size_t>(std::max(threads, 1U));
+		auto const blocks =
+		   static_cast<unsigned>(std::clamp(count / grain, std::size_t{1}, max_blocks));
+		if (blocks == 1) {
+			f(std::size_t{0}, count, 0U);
+			return;
+		}
+
+		auto const block_size = (count + blocks - 1) / blocks;
+		auto pool = std::vector<std::jthread>();
+		pool.reserve(blocks - 1);
+		for (auto t = 1U; t < blocks; ++t) {
+			auto const first = std::min(count, t * block_size);
+			auto const last = std::min(count, first + block_size);
+			pool.emplace_back([&f, first, last, t] { f(first, last, t); });
+		}
+		f(std::size_t{0}, std::min(count, block_size), 0U);
+	}
+
+	// Sorts one block per thread, then merges neighbouring runs pairwise, each round's merges on
+	// separate threads. Not stable.
+	template<typename T, typename Compare = std::less<>>
+	auto parallel_sort(std::vector<T>& values, unsigned threads, Compare const& compare = {})
+	   -> void {
+		auto const at = [&values](std::size_t i) {
+			return std::next(std::begin(values), static_cast<std::ptrdiff_t>(i));
+		};
+		auto blocks = std::vector<std::pair<std::size_t, std::size_t>>(std::max(threads, 1U));
+		auto const sort_block = [&](std::size_t first, std::size_t last, unsigned t) {
+			std::sort(at(first), at(last), compare);
+			blocks[t] = {first, last};
+		};
+		parallel_for(threads, std::size(values), sort_block);
+
+		auto bounds = std::vector<std::size_t>{0};
+		for (auto const& [first, last] : blocks) {
+			if (first != last) {
+				bounds.push_back(last);
+			}
+		}
+		while (std::size(bounds) > 2) {
+			auto merged = std::vector<std::size_t>{0};
+			{
+				auto pool = std::vector<std::jthread>();
+				for (auto i = std::size_t{0}; i + 2 < std::size(bounds); i += 2) {
+					auto const first = bounds[i];
+					auto const middle = bounds[i + 1];
+					auto const last = bounds[i + 2];
+					pool.emplace_back([&at, &compare, first, middle, last] {
+						std::inplace_merge(at(first), at(middle), at(last), compare);
+					});
+					merged.push_back(last);
+				}
+			}
+			if (std::size(bounds) % 2 == 0) {
+				merged.push_back(bounds.back());
+			}
+			bounds = std::move(merged);
+		}
+	}
+
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_PARALLEL_HPP
@@ -0,0 +1,64 @@
+#ifndef GDWG_DETAIL_PERSISTENT_ADJACENCY_HPP
+#define GDWG_DETAIL_PERSISTENT_ADJACENCY_HPP
+
+#include "gdwg/detail/persistent_map.hpp"
+
+#include <iterator>
+#include <variant>
+#include <vector>
+
+namespace gdwg::detail {
+
+	// The edges at one node of a graph built from persistent maps, keyed by the node at the other
+	// end. Each edge is stored twice, in the out map of its source and the in map of its target.
+	template<typename N, typename E>
+	struct persistent_adjacency {
+		using weight_set = persistent_map<E, std::monostate>;
+		using edge_map = persistent_map<N, weight_set>;
+
+		edge_map out;
+		edge_map in;
+
+		[[nodiscard]] static auto contains(edge_map const& edges, N const& to, E const& weight)
+		   -> bool {
+			auto const* weights = edges.find(to);
+			return weights != nullptr and weights->contains(weight);
+		}
+
+		// Adds or removes one weight of the edges to `to`.
+		[[nodiscard]] static auto toggle(edge_map const& edges,
+		                                 N const& to,
+		                                 E const& weight,
+		                                 bool add) -> edge_map {
+			auto const* found = edges.find(to);
+			auto const weights = found == nullptr ? weight_set() : *found;
+			if (add) {
+				return edges.insert_or_assign(to, weights.insert_or_assign(weight, {}));
+			}
+			auto const rest = weights.erase(weight);
+			return rest.empty() ? edges.erase(to) : edges.insert_or_assign(to, rest);
+		}
+
+		// Each neighbour once per edge, the way graph::connections reports them.
+		[[nodiscard]] static auto neighbours(edge_map const& edges) -> std::vector<N> {
+			auto result = std::vector<N>();
+			for (auto const& x : edges) {
+				result.insert(std::end(result), x.value.size(), x.key);
+			}
+			return result;
+		}
+
+		[[nodiscard]] static auto weights(edge_map const& edges, N const& to) -> std::vector<E> {
+			auto result = std::vector<E>();
+			if (auto const* found = edges.find(to)) {
+				for (auto const& w : *found) {
+					result.push_back(w.key);
+				}
+			}
+			return result;
+		}
+	};
+
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_PERSISTENT_ADJACENCY_HPP
@@ -0,0 +1,216 @@
+#ifndef GDWG_DETAIL_PERSISTENT_MAP_HPP
+#define GDWG_DETAIL_PERSISTENT_MAP_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg::detail {
+
+	// An immutable ordered map. Updates return a new map that shares every untouched node with the
+	// old one, so copying a map is O(1) and an update allocates O(log n) nodes in expectation.
+	// Nodes are freed when the last map that reaches them is destroyed. The tree is a treap with
+	// path copying: split and merge copy only the nodes on the path they walk.
+	template<typename K, typename V>
+	class persistent_map {
+	public:
+		struct entry {
+			K key;
+			V value;
+		};
+
+		class iterator;
+
+		persistent_map() noexcept = default;
+
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return root_ == nullptr;
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return size_of(root_);
+		}
+
+		// nullptr if key isn't in the map.
+		[[nodiscard]] auto find(K const& key) const noexcept -> V const* {
+			for (auto const* n = root_.get(); n != nullptr;) {
+				if (key < n->item.key) {
+					n = n->left.get();
+				}
+				else if (n->item.key < key) {
+					n = n->right.get();
+				}
+				else {
+					return &n->item.value;
+				}
+			}
+			return nullptr;
+		}
+
+		[[nodiscard]] auto at(K const& key) const -> V const& {
+			if (auto const* value = find(key)) {
+				return *value;
+			}
+			throw std::out_of_range("Cannot call gdwg::detail::persistent_map::at on a key that isn't "
+			                        "in the map");
+		}
+
+		[[nodiscard]] auto contains(K const& key) const noexcept -> bool {
+			return find(key) != nullptr;
+		}
+
+		[[nodiscard]] auto insert_or_assign(K key, V value) const -> persistent_map {
+			auto [less, rest] = split(root_, key, false);
+			auto greater = split(rest, key, true).second;
+			auto item = std::make_shared<node const>(entry{std::move(key), std::move(value)},
+			                                         next_priority(),
+			                                         nullptr,
+			                                         nullptr);
+			return persistent_map(merge(merge(less, item), greater));
+		}
+
+		[[nodiscard]] auto erase(K const& key) const -> persistent_map {
+			if (not contains(key)) {
+				return *this;
+			}
+			auto [less, rest] = split(root_, key, false);
+			return persistent_map(merge(less, split(rest, key, true).second));
+		}
+
+		[[nodiscard]] auto begin() const -> iterator {
+			return iterator(root_.get());
+		}
+
+		[[nodiscard]] auto end() const -> iterator {
+			return iterator();
+		}
+
+	private:
+		struct node;
+		using link = std::shared_ptr<node const>;
+
+		struct node {
+			node(entry e, std::uint64_t p, link l, link r)
+			: item{std::move(e)}
+			, priority{p}
+			, left{std::move(l)}
+			, right{std::move(r)}
+			, size{1 + size_of(left) + size_of(right)} {}
+
+			entry item;
+			std::uint64_t priority;
+			link left;
+			link right;
+			std::size_t size;
+		};
+
+		explicit persistent_map(link root) noexcept
+		: root_{std::move(root)} {}
+
+		static auto size_of(link const& n) noexcept -> std::size_t {
+			return n == nullptr ? 0 : n->size;
+		}
+
+		// splitmix64 over a shared counter, so priorities are well spread without a random engine.
+		static auto next_priority() noexcept -> std::uint64_t {
+			static auto counter = std::atomic<std::uint64_t>{0};
+			auto z = counter.fetch_add(0x9e3779b97f4a7c15, std::memory_order_relaxed);
+			z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9;
+			z = (z ^ (z >> 27U)) * 0x94d049bb133111eb;
+			return z ^ (z >> 31U);
+		}
+
+		// Splits t into the keys before key and the rest, or with or_equal, the keys up to and
+		// including key and the rest.
+		static auto split(link const& t, K const& key, bool or_equal) -> std::pair<link, link> {
+			if (t == nullptr) {
+				return {};
+			}
+			auto const goes_left = or_equal ? not(key < t->item.key) : t->item.key < key;
+			if (goes_left) {
+				auto [less, rest] = split(t->right, key, or_equal);
+				return {std::make_shared<node const>(t->item, t->priority, t->left, std::move(less)),
+				        std::move(rest)};
+			}
+			auto [less, rest] = split(t->left, key, or_equal);
+			return {std::move(less),
+			        std::make_shared<node const>(t->item, t->priority, std::move(rest), t->right)};
+		}
+
+		// Every key in a comes before every key in b.
+		static auto merge(link const& a, link const& b) -> link {
+			if (a == nullptr) {
+				return b;
+			}
+			if (b == nullptr) {
+				return a;
+			}
+			if (a->priority > b->priority) {
+				return std::make_shared<node const>(a->item, a->priority, a->left, merge(a->right, b));
+			}
+			return std::make_shared<node const>(b->item, b->priority, merge(a, b->left), b->right);
+		}
+
+		link root_;
+
+	public:
+		// In key order. Valid while the map it came from, or any copy of it, is alive.
+		class iterator {
+		public:
+			using value_type = entry;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			iterator() = default;
+
+			auto operator*() const -> entry const& {
+				return path_.back()->item;
+			}
+
+			auto operator->() const -> entry const* {
+				return &path_.back()->item;
+			}
+
+			auto operator++() -> iterator& {
+				auto const* n = path_.back();
+				path_.pop_back();
+				push_left_spine(n->right.get());
+				return *this;
+			}
+			auto operator++(int) -> iterator {
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			auto operator==(iterator const& other) const noexcept -> bool {
+				return path_.empty() ? other.path_.empty()
+				                     : not other.path_.empty() and path_.back() == other.path_.back();
+			}
+
+		private:
+			friend class persistent_map;
+
+			explicit iterator(node const* root) {
+				push_left_spine(root);
+			}
+
+			auto push_left_spine(node const* n) -> void {
+				for (; n != nullptr; n = n->left.get()) {
+					path_.push_back(n);
+				}
+			}
+
+			// The nodes whose keys are still to come, nearest last.
+			std::vector<node const*> path_;
+		};
+	};
+
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_PERSISTENT_MAP_HPP
@@ -0,0 +1,47 @@
+#ifndef GDWG_DETAIL_STRUCTURAL_HASH_HPP
+#define GDWG_DETAIL_STRUCTURAL_HASH_HPP
+
+#include <concepts>
+#include <cstdint>
+#include <functional>
+
+// A hash of a graph's node and edge sets that doesn't depend on the order they were built in. It
+// is the sum of one term per node and one per edge, so an insertion adds a term and an erasure
+// subtracts one.
+namespace gdwg::detail {
+
+	// std::hash<T>()(value), or 0 if T has no std::hash. A graph of such values still has a
+	// fingerprint, but it only tells graphs apart by their numbers of nodes and edges.
+	template<typename T>
+	auto hash_value(T const& value) -> std::uint64_t {
+		if constexpr (requires {
+			              { std::hash<T>()(value) } -> std::convertible_to<std::uint64_t>;
+		              }) {
+			return std::hash<T>()(value);
+		}
+		else {
+			return 0;
+		}
+	}
+
+	// The splitmix64 finalizer. Spreading each term over all 64 bits keeps unrelated sums from
+	// colliding, even when std::hash is the identity, as it is for integers.
+	constexpr auto mix(std::uint64_t z) noexcept -> std::uint64_t {
+		z = (z ^ (z >> 30U)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27U)) * 0x94d049bb133111eb;
+		return z ^ (z >> 31U);
+	}
+
+	constexpr auto node_term(std::uint64_t node) noexcept -> std::uint64_t {
+		return mix(node + 0x9e3779b97f4a7c15);
+	}
+
+	// Not symmetric in from and to, so a -> b and b -> a give different terms.
+	constexpr auto edge_term(std::uint64_t from, std::uint64_t to, std::uint64_t weight) noexcept
+	   -> std::uint64_t {
+		return mix(mix(mix(from + 0x7f4a7c159e3779b9) + to) + weight);
+	}
+
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_STRUCTURAL_HASH_HPP
@@ -0,0 +1,287 @@
+#ifndef GDWG_EDGE_LIST_HPP
+#define GDWG_EDGE_LIST_HPP
+
+#include "gdwg/binary_io.hpp"
+#include "gdwg/detail/graph_access.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// Each line of an edge list is "src dst weight", or "src dst" for an edge of weight E{}.
+	struct edge_list_options {
+		// '\0' splits fields on runs of spaces and tabs, as in SNAP files. Any other character
+		// separates fields exactly, as in CSV, and spaces and tabs around each field are ignored.
+		// Quoted fields aren't supported.
+		char delimiter = '\0';
+		// Lines that start with this character are skipped, as are blank lines.
+		char comment = '#';
+		// Skips the first line.
+		bool header = false;
+		// 0 means one per hardware thread.
+		unsigned threads = 0;
+	};
+
+	// How parse_edge_list turns a field into a node or weight: nullopt if the field is malformed.
+	// Specialise it for other types, or pass parse_edge_list any object with the same parse
+	// member.
+	template<typename T>
+	struct field_parser;
+
+	template<typename T>
+	requires(std::is_arithmetic_v<T> and not std::is_same_v<T, bool>) //
+	struct field_parser<T> {
+		static auto parse(std::string_view field) -> std::optional<T> {
+			auto value = T();
+			auto const* const last = field.data() + std::size(field);
+			auto const [end, error] = std::from_chars(field.data(), last, value);
+			if (error != std::errc() or end != last) {
+				return std::nullopt;
+			}
+			return value;
+		}
+	};
+
+	template<>
+	struct field_parser<std::string> {
+		static auto parse(std::string_view field) -> std::optional<std::string> {
+			return std::string(field);
+		}
+	};
+
+	namespace detail {
+		inline constexpr auto blanks = std::string_view(" \t\r");
+
+		inline auto trim(std::string_view s) noexcept -> std::string_view {
+			auto const first = s.find_first_not_of(blanks);
+			if (first == std::string_view::npos) {
+				return {};
+			}
+			return s.substr(first, s.find_last_not_of(blanks) - first + 1);
+		}
+
+		// Splits a trimmed line into fields, and returns how many there are. Stops counting once
+		// there are more than fields can hold.
+		inline auto split_fields(std::string_view line,
+		                         char delimiter,
+		                         std::array<std::string_view, 3>& fields) noexcept -> std::size_t {
+			auto count = std::size_t{0};
+			if (delimiter == '\0') {
+				for (auto i = std::size_t{0}; i != std::string_view::npos;) {
+					auto const end = std::min(line.find_first_of(blanks, i), std::size(line));
+					if (count == std::size(fields)) {
+						return count + 1;
+					}
+					fields[count++] = line.substr(i, end - i);
+					i = line.find_first_not_of(blanks, end);
+				}
+				return count;
+			}
+			for (auto i = std::size_t{0};;) {
+				auto const end = std::min(line.find(delimiter, i), std::size(line));
+				if (count == std::size(fields)) {
+					return count + 1;
+				}
+				fields[count++] = trim(line.substr(i, end - i));
+				if (end == std::size(line)) {
+					return count;
+				}
+				i = end + 1;
+			}
+		}
+
+		// The edges of the lines that start in one block of the text.
+		template<typename N, typename E>
+		struct edge_list_block {
+			// Each distinct node text in the block, parsed once, in the order first seen.
+			std::vector<N> nodes;
+			// (from, to, weight) over positions in nodes.
+			std::vector<std::tuple<std::size_t, std::size_t, E>> edges;
+			// The lines read before stopping.
+			std::size_t lines = 0;
+			bool malformed = false;
+		};
+
+		// Parses every line that starts in [first, last) of text. Stops at the first malformed
+		// line.
+		template<typename N, typename E, typename NodeParser, typename WeightParser>
+		auto parse_edge_lines(std::string_view text,
+		                      std::size_t first,
+		                      std::size_t last,
+		                      edge_list_options const& options,
+		                      NodeParser const& node_parser,
+		                      WeightParser const& weight_parser) -> edge_list_block<N, E> {
+			auto result = edge_list_block<N, E>();
+			// Positions in result.nodes, or malformed if the node doesn't parse.
+			constexpr auto malformed = std::numeric_limits<std::size_t>::max();
+			auto ids = std::unordered_map<std::string_view, std::size_t>();
+			auto const intern = [&](std::string_view name) -> std::size_t {
+				auto const [it, inserted] = ids.try_emplace(name, std::size(result.nodes));
+				if (inserted) {
+					auto value = node_parser.parse(name);
+					if (not value) {
+						return malformed;
+					}
+					result.nodes.push_back(std::move(*value));
+				}
+				return it->second;
+			};
+
+			auto const skip_header = options.header and first == 0;
+			if (first > 0) {
+				auto const newline = text.find('\n', first - 1);
+				first = newline == std::string_view::npos ? std::size(text) : newline + 1;
+			}
+			auto fields = std::array<std::string_view, 3>();
+			for (auto begin = first; begin < std::min(last, std::size(text)); ++result.lines) {
+				auto const end = std::min(text.find('\n', begin), std::size(text));
+				auto const line = trim(text.substr(begin, end - begin));
+				begin = end + 1;
+				if (line.empty() or line.front() == options.comment
+				    or (skip_header and result.lines == 0)) {
+					continue;
+				}
+
+				auto const count = split_fields(line, options.delimiter, fields);
+				auto const from = count == 2 or count == 3 ? intern(fields[0]) : malformed;
+				auto const to = from != malformed ? intern(fields[1]) : malformed;
+				auto weight = count == 3 ? weight_parser.parse(fields[2]) : std::optional<E>(E());
+				if (to == malformed or not weight) {
+					result.malformed = true;
+					return result;
+				}
+				result.edges.emplace_back(from, to, std::move(*weight));
+			}
+			return result;
+		}
+
+		// The block that position i of a concatenation falls in, given each block's start.
+		inline auto block_of(std::vector<std::size_t> const& starts, std::size_t i) noexcept
+		   -> std::size_t {
+			auto const it = std::upper_bound(std::cbegin(starts), std::cend(starts), i);
+			return static_cast<std::size_t>(it - std::cbegin(starts)) - 1;
+		}
+	} // namespace detail
+
+	// Splits text into one block per thread at line boundaries and parses the blocks in
+	// parallel, each parsing a node's text only the first time it sees it. The blocks' nodes are
+	// then sorted into one table and their edges into (from, to, weight) order over it, and the
+	// graph is built from those in one pass, as read_graph does. Throws std::runtime_error naming
+	// the first malformed line.
+	template<concepts::regular N,
+	         concepts::regular E,
+	         typename NodeParser = field_parser<N>,
+	         typename WeightParser = field_parser<E>>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto parse_edge_list(std::string_view text,
+	                        edge_list_options const& options = {},
+	                        NodeParser const& node_parser = {},
+	                        WeightParser const& weight_parser = {},
+	                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+	      -> graph<N, E> {
+		auto const threads = options.threads == 0 ? detail::default_threads() : options.threads;
+		auto blocks = std::vector<detail::edge_list_block<N, E>>(threads);
+		auto const parse_block = [&](std::size_t first, std::size_t last, unsigned t) {
+			blocks[t] =
+			   detail::parse_edge_lines<N, E>(text, first, last, options, node_parser, weight_parser);
+		};
+		detail::parallel_for(threads, std::size(text), parse_block);
+
+		auto line = std::size_t{0};
+		auto node_starts = std::vector<std::size_t>{0};
+		auto edge_starts = std::vector<std::size_t>{0};
+		for (auto const& block : blocks) {
+			if (block.malformed) {
+				throw std::runtime_error("Cannot call gdwg::parse_edge_list on malformed line "
+				                         + std::to_string(line + block.lines + 1));
+			}
+			line += block.lines;
+			node_starts.push_back(node_starts.back() + std::size(block.nodes));
+			edge_starts.push_back(edge_starts.back() + std::size(block.edges));
+		}
+
+		auto values = std::vector<N>();
+		values.reserve(node_starts.back());
+		for (auto const& block : blocks) {
+			values.insert(std::end(values), std::cbegin(block.nodes), std::cend(block.nodes));
+		}
+		detail::parallel_sort(values, threads);
+		values.erase(std::unique(std::begin(values), std::end(values)), std::end(values));
+
+		// Each block's node positions, mapped to positions in values.
+		auto positions = std::vector<std::size_t>(node_starts.back());
+		auto const find_positions = [&](std::size_t first, std::size_t last, unsigned) {
+			for (auto i = first; i < last; ++i) {
+				auto const b = detail::block_of(node_starts, i);
+				auto const& x = blocks[b].nodes[i - node_starts[b]];
+				auto const it = std::lower_bound(std::cbegin(values), std::cend(values), x);
+				positions[i] = static_cast<std::size_t>(it - std::cbegin(values));
+			}
+		};
+		detail::parallel_for(threads, std::size(positions), find_positions);
+
+		using key = std::tuple<std::size_t, std::size_t, E>;
+		auto keys = std::vector<key>(edge_starts.back());
+		auto const make_keys = [&](std::size_t first, std::size_t last, unsigned) {
+			for (auto i = first; i < last; ++i) {
+				auto const b = detail::block_of(edge_starts, i);
+				auto& edge = blocks[b].edges[i - edge_starts[b]];
+				keys[i] = key{positions[node_starts[b] + std::get<0>(edge)],
+				              positions[node_starts[b] + std::get<1>(edge)],
+				              std::move(std::get<2>(edge))};
+			}
+		};
+		detail::parallel_for(threads, std::size(keys), make_keys);
+		blocks = {};
+		detail::parallel_sort(keys, threads);
+		keys.erase(std::unique(std::begin(keys), std::end(keys)), std::end(keys));
+
+		auto result = graph<N, E>(resource);
+		detail::graph_access::assemble(result, values, keys);
+		return result;
+	}
+
+	// Maps the file rather than reading it, so the text is never copied.
+	template<concepts::regular N,
+	         concepts::regular E,
+	         typename NodeParser = field_parser<N>,
+	         typename WeightParser = field_parser<E>>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto load_edge_list(std::filesystem::path const& path,
+	                       edge_list_options const& options = {},
+	                       NodeParser const& node_parser = {},
+	                       WeightParser const& weight_parser = {},
+	                       std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+	      -> graph<N, E> {
+		auto const file = mapped_file(path);
+		auto const bytes = file.bytes();
+		auto const text =
+		   std::string_view(reinterpret_cast<char const*>(bytes.data()), std::size(bytes));
+		return parse_edge_list<N, E>(text, options, node_parser, weight_parser, resource);
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_EDGE_LIST_HPP
@@ -0,0 +1,168 @@
+#ifndef GDWG_EXPORT_HPP
+#define GDWG_EXPORT_HPP
+
+#include "gdwg/detail/buffered_stream.hpp"
+#include "gdwg/detail/graph_access.hpp"
+#include "gdwg/graph.hpp"
+
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+// Exporters for graph visualisation and analysis tools. Like operator<<, each makes one pass
+// over the nodes and one over the edges, through a large output buffer. Values are written the
+// way operator<< writes them, using the formatting state of the stream passed in.
+namespace gdwg {
+	namespace detail {
+		// The text operator<< gives value. scratch is reused between calls, so the result is only
+		// valid until the next call.
+		template<typename T>
+		auto text_of(std::ostringstream& scratch, T const& value) -> std::string_view {
+			if constexpr (std::is_convertible_v<T const&, std::string_view>) {
+				return value;
+			}
+			else {
+				scratch.str({});
+				scratch << value;
+				return scratch.view();
+			}
+		}
+
+		// Writes text with every character in special replaced by escape(c).
+		template<typename Escape>
+		auto write_escaped(std::ostream& out,
+		                   std::string_view text,
+		                   std::string_view special,
+		                   Escape const& escape) -> void {
+			for (auto i = text.find_first_of(special); i != std::string_view::npos;
+			     i = text.find_first_of(special)) {
+				out.write(text.data(), static_cast<std::streamsize>(i));
+				out << escape(text[i]);
+				text.remove_prefix(i + 1);
+			}
+			out.write(text.data(), static_cast<std::streamsize>(std::size(text)));
+		}
+
+		inline auto write_dot_string(std::ostream& out, std::string_view text) -> void {
+			out.put('"');
+			write_escaped(out, text, "\"\\\n", [](char c) -> std::string_view {
+				switch (c) {
+				case '"': return "\\\"";
+				case '\\': return "\\\\";
+				default: return "\\n";
+				}
+			});
+			out.put('"');
+		}
+
+		inline auto write_xml_text(std::ostream& out, std::string_view text) -> void {
+			write_escaped(out, text, "&<>\"'", [](char c) -> std::string_view {
+				switch (c) {
+				case '&': return "&amp;";
+				case '<': return "&lt;";
+				case '>': return "&gt;";
+				case '"': return "&quot;";
+				default: return "&apos;";
+				}
+			});
+		}
+
+		template<typename T>
+		constexpr auto graphml_type() noexcept -> std::string_view {
+			if constexpr (std::is_same_v<T, bool>) {
+				return "boolean";
+			}
+			else if constexpr (std::is_integral_v<T>) {
+				return "long";
+			}
+			else if constexpr (std::is_floating_point_v<T>) {
+				return "double";
+			}
+			else {
+				return "string";
+			}
+		}
+	} // namespace detail
+
+	// Graphviz DOT: a digraph listing every node, then every edge labelled with its weight.
+	template<concepts::regular N, concepts::regular E>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto write_dot(std::ostream& os, graph<N, E> const& g) -> void {
+		auto const& nodes = detail::graph_access::nodes(g);
+		auto const& edges = detail::graph_access::edges(g);
+		auto out = detail::buffered_stream(os, 16 * std::size(nodes) + 32 * std::size(edges));
+		auto& s = out.stream();
+		auto scratch = std::ostringstream();
+		scratch.copyfmt(os);
+
+		s << "digraph {\n";
+		for (auto const& x : nodes) {
+			s << "  ";
+			detail::write_dot_string(s, detail::text_of(scratch, x));
+			s << ";\n";
+		}
+		for (auto const& e : edges) {
+			s << "  ";
+			detail::write_dot_string(s, detail::text_of(scratch, *e.from));
+			s << " -> ";
+			detail::write_dot_string(s, detail::text_of(scratch, *e.to));
+			s << " [label=";
+			detail::write_dot_string(s, detail::text_of(scratch, e.weight));
+			s << "];\n";
+		}
+		s << "}\n";
+		out.finish();
+	}
+
+	// GraphML: nodes get the IDs n0, n1, ... in value order and carry their value as "name" data;
+	// edges carry their weight as "weight" data.
+	template<concepts::regular N, concepts::regular E>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   auto write_graphml(std::ostream& os, graph<N, E> const& g) -> void {
+		auto const& nodes = detail::graph_access::nodes(g);
+		auto const& edges = detail::graph_access::edges(g);
+		auto out = detail::buffered_stream(os, 64 * std::size(nodes) + 96 * std::size(edges));
+		auto& s = out.stream();
+		auto scratch = std::ostringstream();
+		scratch.copyfmt(os);
+
+		s << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		     "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+		     "  <key id=\"name\" for=\"node\" attr.name=\"name\" attr.type=\""
+		  << detail::graphml_type<N>()
+		  << "\"/>\n"
+		     "  <key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\""
+		  << detail::graphml_type<E>()
+		  << "\"/>\n"
+		     "  <graph edgedefault=\"directed\">\n";
+
+		auto ids = std::unordered_map<N const*, std::size_t>();
+		ids.reserve(std::size(nodes));
+		for (auto const& x : nodes) {
+			auto const id = std::size(ids);
+			ids.emplace(&x, id);
+			s << "    <node id=\"n" << std::to_string(id) << "\"><data key=\"name\">";
+			detail::write_xml_text(s, detail::text_of(scratch, x));
+			s << "</data></node>\n";
+		}
+		for (auto const& e : edges) {
+			s << "    <edge source=\"n" << std::to_string(ids.at(e.from)) << "\" target=\"n"
+			  << std::to_string(ids.at(e.to)) << "\"><data key=\"weight\">";
+			detail::write_xml_text(s, detail::text_of(scratch, e.weight));
+			s << "</data></edge>\n";
+		}
+		s << "  </graph>\n"
+		     "</graphml>\n";
+		out.finish();
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_EXPORT_HPP
@@ -1,23 +1,44 @@
 #ifndef GDWG_GRAPH_HPP
 #define GDWG_GRAPH_HPP
 
+#include "gdwg/detail/buffered_stream.hpp"
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/detail/structural_hash.hpp"
+
 #include <__functional_base>
 #include <algorithm>
 #include <concepts/concepts.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <numeric>
 #include <ostream>
 #include <range/v3/iterator.hpp>
 #include <range/v3/iterator/operations.hpp>
 #include <range/v3/utility.hpp>
+#include <range/v3/view/subrange.hpp>
+#include <range/v3/view/transform.hpp>
 #include <set>
+#include <stdexcept>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace gdwg {
+	namespace detail {
+		struct graph_access;
+
+		// Types that can look a node up without constructing an N, such as std::string_view or a
+		// string literal for std::string nodes. Arrays are taken as the pointers they decay to.
+		template<typename K, typename N>
+		concept node_key = concepts::totally_ordered_with<std::decay_t<K>, N>;
+	} // namespace detail
 
 	template<concepts::regular N, concepts::regular E>
 	requires concepts::totally_ordered<N> //
@@ -31,163 +52,231 @@ namespace gdwg {
 			E weight;
 		};
 
+		// Each node value is stored once, in nodes_. Edges point at those values, which never move
+		// while the node is in the graph.
 		struct edge {
-			std::shared_ptr<N> from;
-			std::shared_ptr<N> to;
+			N const* from;
+			N const* to;
 			E weight;
 		};
 
 		graph() noexcept = default;
 
-		graph(std::initializer_list<N> il)
-		: graph{graph(il.begin(), il.end())} {}
+		// Every node and edge the graph stores is allocated from resource, which must outlive the
+		// graph. Copies use the default resource unless given one.
+		explicit graph(std::pmr::memory_resource* resource) noexcept
+		: nodes_{resource}
+		, edges_{resource}
+		, in_edges_{resource} {}
+
+		graph(std::initializer_list<N> il,
+		      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: graph(il.begin(), il.end(), resource) {}
 
 		template<ranges::forward_iterator I, ranges::sentinel_for<I> S>
-		requires ranges::indirectly_copyable<I, N*> graph(I first, S last) {
-			std::transform(first, last, std::inserter(nodes_, std::begin(nodes_)), [](N x) {
-				return std::make_shared<N>(x);
-			});
+		requires ranges::indirectly_copyable<I, N*>
+		graph(I first, S last, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: graph(resource) {
+			std::copy(first, last, std::inserter(nodes_, std::begin(nodes_)));
+			for (auto const& x : nodes_) {
+				fingerprint_ += node_term(x);
+			}
 		}
 
+		// Reads the input once into flat arrays. Node values are sorted and deduplicated, each edge
+		// becomes a (from, to, weight) key over node positions, and the sorted keys fill edges_ and
+		// in_edges_ front to back, so no set insertion has to search.
 		template<ranges::forward_iterator I, ranges::sentinel_for<I> S>
-		requires ranges::indirectly_copyable<I, value_type*> graph(I first, S last) {
-			std::transform(first, last, std::inserter(nodes_, std::begin(nodes_)), [](value_type x) {
-				return std::make_shared<N>(x.from);
-			});
+		requires ranges::indirectly_copyable<I, value_type*>
+		graph(I first, S last, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: graph(resource) {
+			auto const threads = detail::default_threads();
+			auto const count = static_cast<std::size_t>(ranges::distance(first, last));
+			auto endpoints = std::vector<N>();
+			auto weights = std::vector<E>();
+			endpoints.reserve(2 * count);
+			weights.reserve(count);
+			for (; first != last; ++first) {
+				value_type const& x = *first;
+				endpoints.push_back(x.from);
+				endpoints.push_back(x.to);
+				weights.push_back(x.weight);
+			}
 
-			std::transform(first, last, std::inserter(nodes_, std::begin(nodes_)), [](value_type x) {
-				return std::make_shared<N>(x.to);
-			});
-			std::transform(first, last, std::inserter(edges_, std::begin(edges_)), [this](value_type x) {
-				return std::make_shared<edge>(edge{*nodes_.find(x.from), *nodes_.find(x.to), x.weight});
-			});
+			auto values = endpoints;
+			detail::parallel_sort(values, threads);
+			values.erase(std::unique(std::begin(values), std::end(values)), std::end(values));
+
+			auto keys = std::vector<edge_key>(count);
+			auto const position = [&values](N const& x) {
+				auto const it = std::lower_bound(std::cbegin(values), std::cend(values), x);
+				return static_cast<std::size_t>(it - std::cbegin(values));
+			};
+			auto const make_keys = [&](std::size_t first_key, std::size_t last_key, unsigned) {
+				for (auto i = first_key; i < last_key; ++i) {
+					auto const from = position(endpoints[2 * i]);
+					keys[i] = edge_key{from, position(endpoints[2 * i + 1]), weights[i]};
+				}
+			};
+			detail::parallel_for(threads, count, make_keys);
+			endpoints = std::vector<N>();
+			weights = std::vector<E>();
+			detail::parallel_sort(keys, threads);
+			keys.erase(std::unique(std::begin(keys), std::end(keys)), std::end(keys));
+			assemble(values, keys);
 		}
 
+		// The new graph takes over other's resource.
 		graph(graph&& other) noexcept
-		: nodes_{std::exchange(other.nodes_, std::set<std::shared_ptr<N>, nodes_comparator>())}
-		, edges_{std::exchange(other.edges_, std::set<std::shared_ptr<edge>, edges_comparator>())} {}
-
-		auto operator=(graph&& other) noexcept -> graph& {
-			std::swap(nodes_, other.nodes_);
+		: nodes_{std::exchange(other.nodes_, node_set())}
+		, edges_{std::exchange(other.edges_, edge_set())}
+		, in_edges_{std::exchange(other.in_edges_, in_edge_set())}
+		, fingerprint_{std::exchange(other.fingerprint_, 0)} {}
+
+		// Keeps this graph's resource. If other uses a different one, its contents are copied.
+		auto operator=(graph&& other) -> graph& {
+			if (nodes_.get_allocator() != other.nodes_.get_allocator()) {
+				return *this = std::as_const(other);
+			}
 			std::swap(nodes_, other.nodes_);
+			std::swap(edges_, other.edges_);
+			std::swap(in_edges_, other.in_edges_);
+			std::swap(fingerprint_, other.fingerprint_);
 			return *this;
 		}
 
-		graph(graph const& other) {
-			std::transform(std::cbegin(other.nodes_),
-			               std::cend(other.nodes_),
-			               std::inserter(nodes_, std::begin(nodes_)),
-			               [](std::shared_ptr<N> x) { return std::make_shared<N>(*x); });
+		graph(graph const& other)
+		: graph(other, std::pmr::get_default_resource()) {}
 
+		graph(graph const& other, std::pmr::memory_resource* resource)
+		: nodes_(other.nodes_, resource)
+		, edges_{resource}
+		, in_edges_{resource}
+		, fingerprint_{other.fingerprint_} {
 			std::transform(std::cbegin(other.edges_),
 			               std::cend(other.edges_),
-			               std::inserter(edges_, std::begin(edges_)),
-			               [this](std::shared_ptr<edge> x) {
-				               return std::make_shared<edge>(
-				                  edge{*nodes_.find(*(x->from)), *nodes_.find(*(x->to)), x->weight});
+			               std::inserter(edges_, std::end(edges_)),
+			               [this](edge const& x) {
+				               return edge{node(*x.from), node(*x.to), x.weight};
 			               });
+			index_incoming_edges();
 		}
 
 		auto operator=(graph const& other) -> graph& {
 			if (*this == other) {
 				return *this;
 			}
-			auto tmp = graph<N, E>(other);
+			auto tmp = graph<N, E>(other, resource());
 			std::swap(nodes_, tmp.nodes_);
 			std::swap(edges_, tmp.edges_);
+			std::swap(in_edges_, tmp.in_edges_);
+			std::swap(fingerprint_, tmp.fingerprint_);
 			return *this;
 		}
 		// Your member functions go here
 
 		auto insert_node(N const& value) -> bool {
-			if (is_node(value)) {
-				return false;
+			if (nodes_.insert(value).second) {
+				fingerprint_ += node_term(value);
+				return true;
 			}
-			return nodes_.emplace(std::make_shared<N>(value)).second;
+			return false;
 		}
 
-		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+		template<detail::node_key<N> Src = N, detail::node_key<N> Dst = N>
+		auto insert_edge(Src const& src, Dst const& dst, E const& weight) -> bool {
 			if (is_node(src) && is_node(dst)) {
-				return edges_
-				   .emplace(std::make_shared<edge>(edge{*nodes_.find(src), *nodes_.find(dst), weight}))
-				   .second;
+				return add_edge(edge{node(src), node(dst), weight});
 			}
 			throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edge when either src "
 			                         "or dst node does not exist");
 		}
 
-		auto replace_node(N const& old_data, N const& new_data) -> bool {
+		// Inserts every value in [first, last) and reports, in input order, whether each one was new.
+		// The batch is sorted first, so each value takes one search of nodes_.
+		template<ranges::forward_iterator I, ranges::sentinel_for<I> S>
+		requires ranges::indirectly_copyable<I, N*> //
+		   auto insert_nodes(I first, S last) -> std::vector<bool> {
+			auto values = collect<N>(first, last);
+			auto inserted = std::vector<bool>(std::size(values));
+			for (auto const i : sorted_positions(values, [](N const& x) { return std::tie(x); })) {
+				auto const it = nodes_.lower_bound(values[i]);
+				if (it == std::end(nodes_) or *it != values[i]) {
+					fingerprint_ += node_term(*nodes_.emplace_hint(it, std::move(values[i])));
+					inserted[i] = true;
+				}
+			}
+			return inserted;
+		}
+
+		// Inserts every edge in [first, last) and reports, in input order, whether each one was new.
+		// Throws without changing the graph if any endpoint doesn't exist.
+		template<ranges::forward_iterator I, ranges::sentinel_for<I> S>
+		requires ranges::indirectly_copyable<I, value_type*> //
+		   auto insert_edges(I first, S last) -> std::vector<bool> {
+			auto const batch = resolve_edges(first,
+			                                 last,
+			                                 "Cannot call gdwg::graph<N, E>::insert_edges when either "
+			                                 "src or dst node does not exist");
+			auto inserted = std::vector<bool>(std::size(batch));
+			for (auto const& [i, e] : batch) {
+				auto const it = edges_.lower_bound(e);
+				if (it == std::end(edges_) or edges_comparator()(e, *it)) {
+					in_edges_.insert(&*edges_.emplace_hint(it, e));
+					fingerprint_ += edge_term(e);
+					inserted[i] = true;
+				}
+			}
+			return inserted;
+		}
+
+		// Erases every edge in [first, last) and reports, in input order, whether each one was
+		// there. Throws without changing the graph if any endpoint doesn't exist.
+		template<ranges::forward_iterator I, ranges::sentinel_for<I> S>
+		requires ranges::indirectly_copyable<I, value_type*> //
+		   auto erase_edges(I first, S last) -> std::vector<bool> {
+			auto const batch = resolve_edges(first,
+			                                 last,
+			                                 "Cannot call gdwg::graph<N, E>::erase_edges on src or "
+			                                 "dst if they don't exist in the graph");
+			auto erased = std::vector<bool>(std::size(batch));
+			for (auto const& [i, e] : batch) {
+				auto const it = edges_.find(e);
+				if (it != std::end(edges_)) {
+					remove_edge(it);
+					erased[i] = true;
+				}
+			}
+			return erased;
+		}
+
+		template<detail::node_key<N> Old = N>
+		auto replace_node(Old const& old_data, N const& new_data) -> bool {
 			if (is_node(old_data)) {
 				if (is_node(new_data)) {
 					return false;
 				}
 				auto old_node = nodes_.find(old_data);
-				auto new_node = std::make_shared<N>(new_data);
-				nodes_.emplace(new_node);
-
-				auto to_change = std::find_if(
-				   std::cbegin(edges_),
-				   std::cend(edges_),
-				   [old_data](std::shared_ptr<edge> x) { return (*(x->from) == old_data); });
-
-				while (to_change != std::cend(edges_)) {
-					insert_edge(*new_node, *((*to_change)->to), (*to_change)->weight);
-					edges_.erase(to_change);
-					to_change = std::find_if(
-					   std::cbegin(edges_),
-					   std::cend(edges_),
-					   [old_data](std::shared_ptr<edge> x) { return (*(x->from) == old_data); });
-				}
-				to_change =
-				   std::find_if(std::cbegin(edges_),
-				                std::cend(edges_),
-				                [old_data](std::shared_ptr<edge> x) { return (*(x->to) == old_data); });
-				while (to_change != std::cend(edges_)) {
-					insert_edge(*((*to_change)->from), *new_node, (*to_change)->weight);
-					edges_.erase(to_change);
-					to_change = std::find_if(
-					   std::cbegin(edges_),
-					   std::cend(edges_),
-					   [old_data](std::shared_ptr<edge> x) { return (*(x->to) == old_data); });
-				}
-				nodes_.erase(old_node);
+				auto new_node = nodes_.insert(new_data).first;
+				fingerprint_ += node_term(*new_node);
+				redirect_edges(&*old_node, &*new_node);
+				remove_node(old_node);
 				return true;
 			}
 			throw std::runtime_error("Cannot call gdwg::graph<N, E>::replace_node on a node that "
 			                         "doesn't exist");
 		}
 
-		auto merge_replace_node(N const& old_data, N const& new_data) -> void {
+		template<detail::node_key<N> Old = N, detail::node_key<N> New = N>
+		auto merge_replace_node(Old const& old_data, New const& new_data) -> void {
 			if (is_node(old_data) and is_node(new_data)) {
 				auto old_node = nodes_.find(old_data);
-
-				auto to_change = std::find_if(
-				   std::cbegin(edges_),
-				   std::cend(edges_),
-				   [old_data](std::shared_ptr<edge> x) { return (*(x->from) == old_data); });
-
-				while (to_change != std::cend(edges_)) {
-					insert_edge(new_data, *((*to_change)->to), (*to_change)->weight);
-					edges_.erase(to_change);
-					to_change = std::find_if(
-					   std::cbegin(edges_),
-					   std::cend(edges_),
-					   [old_data](std::shared_ptr<edge> x) { return (*(x->from) == old_data); });
+				auto const* new_node = node(new_data);
+				if (&*old_node == new_node) {
+					return;
 				}
-
-				to_change =
-				   std::find_if(std::cbegin(edges_),
-				                std::cend(edges_),
-				                [old_data](std::shared_ptr<edge> x) { return (*(x->to) == old_data); });
-				while (to_change != std::cend(edges_)) {
-					insert_edge(*((*to_change)->from), new_data, (*to_change)->weight);
-					edges_.erase(to_change);
-					to_change = std::find_if(
-					   std::cbegin(edges_),
-					   std::cend(edges_),
-					   [old_data](std::shared_ptr<edge> x) { return (*(x->to) == old_data); });
-				}
-				nodes_.erase(old_node);
+				redirect_edges(&*old_node, new_node);
+				remove_node(old_node);
 			}
 			else {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::merge_replace_node on old or "
@@ -195,46 +284,54 @@ namespace gdwg {
 			}
 		}
 
-		auto erase_node(N const& value) -> bool {
+		template<detail::node_key<N> K = N>
+		auto erase_node(K const& value) -> bool {
 			if (is_node(value)) {
-				std::erase_if(edges_, [value](std::shared_ptr<edge> x) {
-					return (*(x->from) == value or *(x->to) == value);
-				});
-				nodes_.erase(nodes_.find(value));
+				remove_incident_edges(value);
+				remove_node(nodes_.find(value));
 
 				return true;
 			}
 			return false;
 		}
 
-		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+		template<detail::node_key<N> Src = N, detail::node_key<N> Dst = N>
+		auto erase_edge(Src const& src, Dst const& dst, E const& weight) -> bool {
 			if (is_node(src) and is_node(dst)) {
-				auto erased = std::erase_if(edges_, [src, dst, weight](std::shared_ptr<edge> x) {
-					return (*(x->from) == src and *(x->to) == dst and x->weight == weight);
-				});
-				return (erased != 0);
+				auto const it = edges_.find(std::tie(src, dst, weight));
+				if (it == std::cend(edges_)) {
+					return false;
+				}
+				remove_edge(it);
+				return true;
 			}
 			throw std::runtime_error("Cannot call gdwg::graph<N, E>::erase_edge on src or dst if they "
 			                         "don't exist in the graph");
 		}
 
 		auto erase_edge(iterator i) -> iterator {
-			i.graph_it_ = edges_.erase(i.graph_it_);
+			i.graph_it_ = remove_edge(i.graph_it_);
 			return i;
 		}
 
 		auto erase_edge(iterator i, iterator s) -> iterator {
-			i.graph_it_ = edges_.erase(i.graph_it_, s.graph_it_);
+			while (i.graph_it_ != s.graph_it_) {
+				i.graph_it_ = remove_edge(i.graph_it_);
+			}
 			return i;
 		}
 
 		auto clear() noexcept -> void {
-			nodes_.clear();
+			in_edges_.clear();
 			edges_.clear();
+			nodes_.clear();
+			fingerprint_ = 0;
 		}
 
 		// accessors
-		[[nodiscard]] auto is_node(N const& value) const -> bool {
+		// Every member that looks nodes up also takes any detail::node_key in place of an N.
+		template<detail::node_key<N> K = N>
+		[[nodiscard]] auto is_node(K const& value) const -> bool {
 			return (nodes_.find(value) != std::cend(nodes_));
 		}
 
@@ -242,44 +339,40 @@ namespace gdwg {
 			return nodes_.empty();
 		}
 
-		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+		// A hash of the nodes and edges that every change keeps up to date in O(1). Equal graphs
+		// have equal fingerprints however they were built, so a graph whose fingerprint differs
+		// from an earlier reading has changed since. Undoing a change restores the old value. The
+		// value comes from std::hash, so it may differ between builds.
+		[[nodiscard]] auto fingerprint() const noexcept -> std::uint64_t {
+			return fingerprint_;
+		}
+
+		[[nodiscard]] auto resource() const noexcept -> std::pmr::memory_resource* {
+			return nodes_.get_allocator().resource();
+		}
+
+		template<detail::node_key<N> Src = N, detail::node_key<N> Dst = N>
+		[[nodiscard]] auto is_connected(Src const& src, Dst const& dst) const -> bool {
 			if (is_node(src) and is_node(dst)) {
-				auto connection = std::find_if(std::cbegin(edges_),
-				                               std::cend(edges_),
-				                               [src, dst](std::shared_ptr<edge> x) {
-					                               return (*(x->from) == src and *(x->to) == dst);
-				                               });
-				return connection != std::cend(edges_);
+				auto const [first, last] = edges_.equal_range(std::tie(src, dst));
+				return first != last;
 			}
 			throw std::runtime_error("Cannot call gdwg::graph<N, E>::is_connected if src or dst node "
 			                         "don't exist in the graph");
 		}
 
 		[[nodiscard]] auto nodes() const -> std::vector<N> {
-			auto result = std::vector<N>();
-			std::transform(std::cbegin(nodes_),
-			               std::cend(nodes_),
-			               std::back_inserter(result),
-			               [](std::shared_ptr<N> x) { return *x; });
-			return result;
+			return std::vector<N>(std::cbegin(nodes_), std::cend(nodes_));
 		}
 
-		[[nodiscard]] auto weights(N const& src, N const& dst) const -> std::vector<E> {
+		template<detail::node_key<N> Src = N, detail::node_key<N> Dst = N>
+		[[nodiscard]] auto weights(Src const& src, Dst const& dst) const -> std::vector<E> {
 			if (is_node(src) and is_node(dst)) {
-				auto tmp = std::vector<std::shared_ptr<edge>>();
-
-				std::copy_if(std::cbegin(edges_),
-				             std::cend(edges_),
-				             std::back_inserter(tmp),
-				             [src, dst](std::shared_ptr<edge> x) {
-					             return *(x->from) == src and *(x->to) == dst;
-				             });
-
+				auto const [first, last] = edges_.equal_range(std::tie(src, dst));
 				auto result = std::vector<E>();
-				std::transform(std::cbegin(tmp),
-				               std::cend(tmp),
-				               std::back_inserter(result),
-				               [](std::shared_ptr<edge> x) { return x->weight; });
+				std::transform(first, last, std::back_inserter(result), [](edge const& x) {
+					return x.weight;
+				});
 				return result;
 			}
 
@@ -287,37 +380,80 @@ namespace gdwg {
 			                         "don't exist in the graph");
 		}
 
-		[[nodiscard]] auto find(N const& src, N const& dst, E const& weight) const -> iterator {
-			auto g_it = iterator();
-			g_it.graph_it_ = std::find_if(std::cbegin(edges_),
-			                              std::cend(edges_),
-			                              [src, dst, weight](std::shared_ptr<edge> x) {
-				                              return *(x->from) == src and *(x->to) == dst
-				                                     and x->weight == weight;
-			                              });
-			return g_it;
+		template<detail::node_key<N> Src = N, detail::node_key<N> Dst = N>
+		[[nodiscard]] auto find(Src const& src, Dst const& dst, E const& weight) const -> iterator {
+			return iterator(edges_.find(std::tie(src, dst, weight)));
 		}
 
-		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+		template<detail::node_key<N> K = N>
+		[[nodiscard]] auto connections(K const& src) const -> std::vector<N> {
 			if (is_node(src)) {
-				auto tmp = std::vector<std::shared_ptr<edge>>();
-
-				std::copy_if(std::cbegin(edges_),
-				             std::cend(edges_),
-				             std::back_inserter(tmp),
-				             [src](std::shared_ptr<edge> x) { return *(x->from) == src; });
-
+				auto const [first, last] = edges_.equal_range(std::tie(src));
 				auto result = std::vector<N>();
-				std::transform(std::cbegin(tmp),
-				               std::cend(tmp),
-				               std::back_inserter(result),
-				               [](std::shared_ptr<edge> x) { return *(x->to); });
+				std::transform(first, last, std::back_inserter(result), [](edge const& x) {
+					return *x.to;
+				});
 				return result;
 			}
 			throw std::runtime_error("Cannot call gdwg::graph<N, E>::connections if src doesn't exist "
 			                         "in the graph");
 		}
 
+		// The sources of every edge into dst, ordered by (src, weight).
+		template<detail::node_key<N> K = N>
+		[[nodiscard]] auto connections_to(K const& dst) const -> std::vector<N> {
+			if (is_node(dst)) {
+				auto const [first, last] = in_edges_.equal_range(std::tie(dst));
+				auto result = std::vector<N>();
+				std::transform(first, last, std::back_inserter(result), [](edge const* x) {
+					return *x->from;
+				});
+				return result;
+			}
+			throw std::runtime_error("Cannot call gdwg::graph<N, E>::connections_to if dst doesn't "
+			                         "exist in the graph");
+		}
+
+		// Lazy counterparts of nodes(), weights(), connections() and connections_to() that
+		// allocate nothing and yield references into the graph. A view is invalidated by any
+		// change to the nodes or edges it ranges over.
+		[[nodiscard]] auto nodes_view() const noexcept {
+			return ranges::subrange(std::cbegin(nodes_), std::cend(nodes_));
+		}
+
+		template<detail::node_key<N> Src = N, detail::node_key<N> Dst = N>
+		[[nodiscard]] auto weights_view(Src const& src, Dst const& dst) const {
+			if (is_node(src) and is_node(dst)) {
+				auto const [first, last] = edges_.equal_range(std::tie(src, dst));
+				return ranges::subrange(first, last)
+				       | ranges::views::transform([](edge const& x) -> E const& { return x.weight; });
+			}
+			throw std::runtime_error("Cannot call gdwg::graph<N, E>::weights_view if src or dst node "
+			                         "don't exist in the graph");
+		}
+
+		template<detail::node_key<N> K = N>
+		[[nodiscard]] auto connections_view(K const& src) const {
+			if (is_node(src)) {
+				auto const [first, last] = edges_.equal_range(std::tie(src));
+				return ranges::subrange(first, last)
+				       | ranges::views::transform([](edge const& x) -> N const& { return *x.to; });
+			}
+			throw std::runtime_error("Cannot call gdwg::graph<N, E>::connections_view if src doesn't "
+			                         "exist in the graph");
+		}
+
+		template<detail::node_key<N> K = N>
+		[[nodiscard]] auto connections_to_view(K const& dst) const {
+			if (is_node(dst)) {
+				auto const [first, last] = in_edges_.equal_range(std::tie(dst));
+				return ranges::subrange(first, last)
+				       | ranges::views::transform([](edge const* x) -> N const& { return *x->from; });
+			}
+			throw std::runtime_error("Cannot call gdwg::graph<N, E>::connections_to_view if dst "
+			                         "doesn't exist in the graph");
+		}
+
 		[[nodiscard]] auto begin() const -> iterator {
 			return iterator(std::begin(edges_));
 		}
@@ -327,86 +463,283 @@ namespace gdwg {
 		}
 
 		[[nodiscard]] auto operator==(graph const& other) const -> bool {
-			if (std::size(other.nodes_) == std::size(nodes_)
+			if (other.fingerprint_ == fingerprint_ and std::size(other.nodes_) == std::size(nodes_)
 			    and std::size(other.edges_) == std::size(edges_)) {
-				auto node_equality = std::equal(
-				   std::cbegin(nodes_),
-				   std::cend(nodes_),
-				   std::cbegin(other.nodes_),
-				   [](std::shared_ptr<N> const& a, std::shared_ptr<N> const& b) { return *a == *b; });
+				auto node_equality =
+				   std::equal(std::cbegin(nodes_), std::cend(nodes_), std::cbegin(other.nodes_));
 
 				return node_equality
 				       and std::equal(std::cbegin(edges_),
 				                      std::cend(edges_),
 				                      std::cbegin(other.edges_),
-				                      [](std::shared_ptr<edge> const& a, std::shared_ptr<edge> const& b) {
-					                      return *(a->from) == *(b->from) and *(a->to) == *(b->to)
-					                             and a->weight == b->weight;
+				                      [](edge const& a, edge const& b) {
+					                      return *a.from == *b.from and *a.to == *b.to
+					                             and a.weight == b.weight;
 				                      });
 			}
 			return false;
 		}
 
+		// edges_ is ordered by source the same way nodes_ is, so one pass over each prints every
+		// node followed by its outgoing edges. Small graphs are written straight to os.
 		friend auto operator<<(std::ostream& os, graph const& g) -> std::ostream& {
-			std::for_each(std::cbegin(g.nodes_), std::cend(g.nodes_), [&os, g](std::shared_ptr<N> x) {
-				os << *x << " (\n";
-				auto to_print = std::find_if(std::cbegin(g.edges_),
-				                             std::cend(g.edges_),
-				                             [x](std::shared_ptr<edge> y) { return (*(y->from) == *x); });
-
-				while (to_print != std::cend(g.edges_)) {
-					os << "  " << *((*to_print)->to) << " | " << (*to_print)->weight << "\n";
-					++to_print;
-					to_print = std::find_if(to_print, std::cend(g.edges_), [x](std::shared_ptr<edge> y) {
-						return (*(y->from) == *x);
-					});
+			auto out = detail::buffered_stream(os, 16 * (std::size(g.nodes_) + std::size(g.edges_)));
+			auto& s = out.stream();
+			auto e = std::cbegin(g.edges_);
+			for (auto const& x : g.nodes_) {
+				s << x << " (\n";
+				for (; e != std::cend(g.edges_) and e->from == &x; ++e) {
+					s << "  " << *e->to << " | " << e->weight << "\n";
 				}
-				os << ")\n";
-			});
-
+				s << ")\n";
+			}
+			out.finish();
 			return os;
 		}
 
 	private:
-		struct nodes_comparator {
+		friend struct detail::graph_access;
+
+		// Orders edges by (from, to, weight), or by (to, from, weight) for the incoming index. A
+		// tuple holding a prefix of that key finds the contiguous run of edges that share it,
+		// e.g. std::tie(src) for every edge out of src.
+		template<bool Incoming>
+		struct edge_order {
 			using is_transparent = void;
 
-			auto operator()(std::shared_ptr<N> const& a, std::shared_ptr<N> const& b) const noexcept
-			   -> bool {
-				return *a < *b;
+			auto operator()(edge const& a, edge const& b) const noexcept -> bool {
+				return prefix<3>(a) < prefix<3>(b);
+			}
+
+			template<typename... Key>
+			auto operator()(edge const& a, std::tuple<Key...> const& b) const noexcept -> bool {
+				return prefix<sizeof...(Key)>(a) < b;
+			}
+
+			template<typename... Key>
+			auto operator()(std::tuple<Key...> const& a, edge const& b) const noexcept -> bool {
+				return a < prefix<sizeof...(Key)>(b);
+			}
+
+			auto operator()(edge const* a, edge const* b) const noexcept -> bool {
+				return (*this)(*a, *b);
 			}
 
-			auto operator()(std::shared_ptr<N> const& a, N const& b) const noexcept -> bool {
-				return *a < b;
+			template<typename... Key>
+			auto operator()(edge const* a, std::tuple<Key...> const& b) const noexcept -> bool {
+				return (*this)(*a, b);
 			}
 
-			auto operator()(N const& a, std::shared_ptr<N> const& b) const noexcept -> bool {
-				return a < *b;
+			template<typename... Key>
+			auto operator()(std::tuple<Key...> const& a, edge const* b) const noexcept -> bool {
+				return (*this)(a, *b);
+			}
+
+		private:
+			template<std::size_t Size>
+			static auto prefix(edge const& e) noexcept {
+				auto const& first = Incoming ? *e.to : *e.from;
+				auto const& second = Incoming ? *e.from : *e.to;
+				if constexpr (Size == 1) {
+					return std::tie(first);
+				}
+				else if constexpr (Size == 2) {
+					return std::tie(first, second);
+				}
+				else {
+					return std::tie(first, second, e.weight);
+				}
 			}
 		};
 
-		struct edges_comparator {
-			using is_transparent = void;
-			auto operator()(std::shared_ptr<edge> const& a,
-			                std::shared_ptr<edge> const& b) const noexcept -> bool {
-				if (*(a->from) != *(b->from)) {
-					return *(a->from) < *(b->from);
+		using edges_comparator = edge_order<false>;
+		using in_edges_comparator = edge_order<true>;
+		using node_set = std::pmr::set<N, std::less<>>;
+		using edge_set = std::pmr::set<edge, edges_comparator>;
+		using in_edge_set = std::pmr::set<edge const*, in_edges_comparator>;
+		using edge_iterator = typename edge_set::iterator;
+		using edge_key = std::tuple<std::size_t, std::size_t, E>;
+
+		template<typename K>
+		[[nodiscard]] auto node(K const& value) const -> N const* {
+			return &*nodes_.find(value);
+		}
+
+		// nullptr if value isn't a node.
+		template<typename K>
+		[[nodiscard]] auto find_node(K const& value) const -> N const* {
+			auto const it = nodes_.find(value);
+			return it == std::cend(nodes_) ? nullptr : &*it;
+		}
+
+		template<typename T, typename I, typename S>
+		static auto collect(I first, S last) -> std::vector<T> {
+			auto result = std::vector<T>();
+			result.reserve(static_cast<std::size_t>(ranges::distance(first, last)));
+			for (; first != last; ++first) {
+				result.push_back(*first);
+			}
+			return result;
+		}
+
+		// The positions of values, ordered by key(value) and then by position.
+		template<typename T, typename Key>
+		static auto sorted_positions(std::vector<T> const& values, Key const& key)
+		   -> std::vector<std::size_t> {
+			auto positions = std::vector<std::size_t>(std::size(values));
+			std::iota(std::begin(positions), std::end(positions), std::size_t{0});
+			std::stable_sort(std::begin(positions),
+			                 std::end(positions),
+			                 [&values, &key](std::size_t a, std::size_t b) {
+				                 return key(values[a]) < key(values[b]);
+			                 });
+			return positions;
+		}
+
+		// Pairs each edge in [first, last) with its input position, sorted by (from, to, weight).
+		// Runs of edges with the same source share one lookup of it.
+		template<typename I, typename S>
+		auto resolve_edges(I first, S last, char const* missing_node) const
+		   -> std::vector<std::pair<std::size_t, edge>> {
+			auto const values = collect<value_type>(first, last);
+			auto const key = [](value_type const& x) { return std::tie(x.from, x.to, x.weight); };
+			auto batch = std::vector<std::pair<std::size_t, edge>>();
+			batch.reserve(std::size(values));
+			N const* from = nullptr;
+			for (auto const i : sorted_positions(values, key)) {
+				auto const& x = values[i];
+				if (from == nullptr or *from != x.from) {
+					from = find_node(x.from);
+				}
+				auto const* to = find_node(x.to);
+				if (from == nullptr or to == nullptr) {
+					throw std::runtime_error(missing_node);
 				}
+				batch.emplace_back(i, edge{from, to, x.weight});
+			}
+			return batch;
+		}
 
-				if (*(a->to) != *(b->to)) {
-					return *(a->to) < *(b->to);
+		// Fills an empty graph from sorted, unique node values and sorted, unique edge keys over
+		// positions in values.
+		auto assemble(std::vector<N>& values, std::vector<edge_key> const& keys) -> void {
+			auto handles = std::vector<N const*>();
+			auto hashes = std::vector<std::uint64_t>();
+			handles.reserve(std::size(values));
+			hashes.reserve(std::size(values));
+			for (auto& x : values) {
+				hashes.push_back(detail::hash_value(x));
+				fingerprint_ += detail::node_term(hashes.back());
+				handles.push_back(&*nodes_.insert(std::end(nodes_), std::move(x)));
+			}
+
+			// Edges are added in (from, to, weight) order. A stable counting sort on the target
+			// then gives the (to, from, weight) order of in_edges_.
+			auto added = std::vector<edge const*>();
+			auto by_target = std::vector<std::size_t>(std::size(values) + 1, 0);
+			added.reserve(std::size(keys));
+			for (auto const& [from, to, weight] : keys) {
+				auto const it =
+				   edges_.emplace_hint(std::end(edges_), edge{handles[from], handles[to], weight});
+				added.push_back(&*it);
+				fingerprint_ +=
+				   detail::edge_term(hashes[from], hashes[to], detail::hash_value(weight));
+				++by_target[to + 1];
+			}
+			std::partial_sum(std::cbegin(by_target), std::cend(by_target), std::begin(by_target));
+			auto incoming = std::vector<edge const*>(std::size(added));
+			for (auto i = std::size_t{0}; i < std::size(keys); ++i) {
+				incoming[by_target[std::get<1>(keys[i])]++] = added[i];
+			}
+			for (auto const* e : incoming) {
+				in_edges_.insert(std::end(in_edges_), e);
+			}
+		}
+
+		auto index_incoming_edges() -> void {
+			std::transform(std::cbegin(edges_),
+			               std::cend(edges_),
+			               std::inserter(in_edges_, std::end(in_edges_)),
+			               [](edge const& x) { return &x; });
+		}
+
+		auto add_edge(edge const& e) -> bool {
+			auto const [it, inserted] = edges_.insert(e);
+			if (inserted) {
+				in_edges_.insert(&*it);
+				fingerprint_ += edge_term(e);
+			}
+			return inserted;
+		}
+
+		auto remove_edge(edge_iterator it) -> edge_iterator {
+			fingerprint_ -= edge_term(*it);
+			in_edges_.erase(&*it);
+			return edges_.erase(it);
+		}
+
+		auto remove_node(typename node_set::iterator it) -> void {
+			fingerprint_ -= node_term(*it);
+			nodes_.erase(it);
+		}
+
+		static auto node_term(N const& value) -> std::uint64_t {
+			return detail::node_term(detail::hash_value(value));
+		}
+
+		static auto edge_term(edge const& e) -> std::uint64_t {
+			return detail::edge_term(detail::hash_value(*e.from),
+			                         detail::hash_value(*e.to),
+			                         detail::hash_value(e.weight));
+		}
+
+		template<typename K>
+		auto remove_incident_edges(K const& value) -> void {
+			auto [out_first, out_last] = edges_.equal_range(std::tie(value));
+			while (out_first != out_last) {
+				out_first = remove_edge(out_first);
+			}
+			auto [in_first, in_last] = in_edges_.equal_range(std::tie(value));
+			while (in_first != in_last) {
+				fingerprint_ -= edge_term(**in_first);
+				edges_.erase(**in_first);
+				in_first = in_edges_.erase(in_first);
+			}
+		}
+
+		// Moves every edge into or out of old_node onto new_node. Edges that new_node already has
+		// are dropped.
+		auto redirect_edges(N const* old_node, N const* new_node) -> void {
+			auto const [out_first, out_last] = edges_.equal_range(std::tie(*old_node));
+			auto const [in_first, in_last] = in_edges_.equal_range(std::tie(*old_node));
+			auto incident = std::vector<edge>(out_first, out_last);
+			std::for_each(in_first, in_last, [&incident, old_node](edge const* x) {
+				if (x->from != old_node) {
+					incident.push_back(*x);
 				}
+			});
 
-				return a->weight < b->weight;
+			remove_incident_edges(*old_node);
+			for (auto& e : incident) {
+				if (e.from == old_node) {
+					e.from = new_node;
+				}
+				if (e.to == old_node) {
+					e.to = new_node;
+				}
+				add_edge(e);
 			}
-		};
+		}
 
-		std::set<std::shared_ptr<N>, nodes_comparator> nodes_;
-		std::set<std::shared_ptr<edge>, edges_comparator> edges_;
+		node_set nodes_;
+		edge_set edges_;
+		// The same edges as edges_, ordered by destination.
+		in_edge_set in_edges_;
+		std::uint64_t fingerprint_ = 0;
 
 	public:
 		class iterator {
-			using graph_iterator = typename std::set<std::shared_ptr<edge>, edges_comparator>::iterator;
+			using graph_iterator = edge_iterator;
 
 		public:
 			using value_type = ranges::common_tuple<N, N, E>;
@@ -418,9 +751,9 @@ namespace gdwg {
 
 			// Iterator source
 			auto operator*() const -> ranges::common_tuple<N const&, N const&, E const&> {
-				return ranges::common_tuple<N const&, N const&, E const&>(*((*graph_it_)->from),
-				                                                          *((*graph_it_)->to),
-				                                                          (*graph_it_)->weight);
+				return ranges::common_tuple<N const&, N const&, E const&>(*graph_it_->from,
+				                                                          *graph_it_->to,
+				                                                          graph_it_->weight);
 			}
 			// Iterator traversal
 			auto operator++() -> iterator& {
@@ -0,0 +1,235 @@
+#ifndef GDWG_PAGERANK_HPP
+#define GDWG_PAGERANK_HPP
+
+#include "gdwg/csr_view.hpp"
+#include "gdwg/detail/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// A read-only square sparse matrix in compressed-sparse-row form, indexed by csr_view node IDs.
+	// It is the shared core of the iterative analytics: PageRank here, and Katz or HITS can be
+	// built from the same factories and multiply().
+	class sparse_matrix {
+	public:
+		using index = std::uint32_t;
+
+		sparse_matrix() = default;
+
+		sparse_matrix(std::vector<std::size_t> offsets,
+		              std::vector<index> columns,
+		              std::vector<double> values)
+		: offsets_{std::move(offsets)}
+		, columns_{std::move(columns)}
+		, values_{std::move(values)} {
+			if (offsets_.empty() or offsets_.back() != columns_.size()
+			    or columns_.size() != values_.size())
+			{
+				throw std::runtime_error("Cannot construct gdwg::sparse_matrix from offsets, columns "
+				                         "and values that don't agree in size");
+			}
+		}
+
+		// Row v holds the weight of every edge u -> v at column u, so multiply() pulls values along
+		// incoming edges.
+		template<typename N, typename E>
+		requires std::is_arithmetic_v<E> //
+		   static auto incoming(csr_view<N, E> const& g) -> sparse_matrix {
+			return from_adjacency(g.reverse(), [](index, E w) { return static_cast<double>(w); });
+		}
+
+		// Row u holds the weight of every edge u -> v at column v.
+		template<typename N, typename E>
+		requires std::is_arithmetic_v<E> //
+		   static auto outgoing(csr_view<N, E> const& g) -> sparse_matrix {
+			return from_adjacency(g.forward(), [](index, E w) { return static_cast<double>(w); });
+		}
+
+		// Like incoming(), with each edge u -> v divided by the total weight leaving u. Column u
+		// sums to one, or to zero if u has no outgoing weight.
+		template<typename N, typename E>
+		requires std::is_arithmetic_v<E> //
+		   static auto transition(csr_view<N, E> const& g) -> sparse_matrix {
+			auto const out_weights = out_weight_sums(g);
+			return from_adjacency(g.reverse(), [&out_weights](index u, E w) {
+				return out_weights[u] == 0.0 ? 0.0 : static_cast<double>(w) / out_weights[u];
+			});
+		}
+
+		[[nodiscard]] auto rows() const noexcept -> std::size_t {
+			return offsets_.size() - 1;
+		}
+
+		[[nodiscard]] auto nonzeros() const noexcept -> std::size_t {
+			return values_.size();
+		}
+
+		// y = Ax. Rows are split into contiguous blocks, one per thread. Returns the L1 distance
+		// between y and x, which is the change made by one step of a fixed-point iteration.
+		auto multiply(std::span<double const> x, std::span<double> y, unsigned threads) const
+		   -> double {
+			return multiply(x, y, threads, [](std::size_t, double sum) { return sum; });
+		}
+
+		// y[i] = finish(i, (Ax)[i]), so a caller can fold a per-row update into the same pass.
+		template<typename Finish>
+		auto multiply(std::span<double const> x,
+		              std::span<double> y,
+		              unsigned threads,
+		              Finish const& finish) const -> double {
+			if (x.size() != rows() or y.size() != rows()) {
+				throw std::runtime_error("Cannot call gdwg::sparse_matrix::multiply with vectors that "
+				                         "don't match the matrix");
+			}
+			auto change = std::vector<double>(std::max(threads, 1U));
+			auto const multiply_rows = [&](std::size_t first, std::size_t last, unsigned t) {
+				auto local = 0.0;
+				for (auto row = first; row < last; ++row) {
+					auto sum = 0.0;
+					for (auto e = offsets_[row]; e < offsets_[row + 1]; ++e) {
+						sum += values_[e] * x[columns_[e]];
+					}
+					auto const value = finish(row, sum);
+					local += std::abs(value - x[row]);
+					y[row] = value;
+				}
+				change[t] = local;
+			};
+			detail::parallel_for(threads, rows(), multiply_rows);
+			return std::accumulate(change.begin(), change.end(), 0.0);
+		}
+
+	private:
+		template<typename N, typename E>
+		static auto out_weight_sums(csr_view<N, E> const& g) -> std::vector<double> {
+			auto const& out = g.forward();
+			auto sums = std::vector<double>(g.node_count());
+			for (auto u = index{0}; u < g.node_count(); ++u) {
+				auto const weights = out.weights_of(u);
+				sums[u] = std::accumulate(weights.begin(), weights.end(), 0.0);
+			}
+			return sums;
+		}
+
+		template<typename Adjacency, typename Value>
+		static auto from_adjacency(Adjacency const& a, Value const& value) -> sparse_matrix {
+			auto values = std::vector<double>(a.weights.size());
+			for (auto e = std::size_t{0}; e < values.size(); ++e) {
+				values[e] = value(a.neighbours[e], a.weights[e]);
+			}
+			return sparse_matrix(a.offsets, a.neighbours, std::move(values));
+		}
+
+		std::vector<std::size_t> offsets_ = {0};
+		std::vector<index> columns_;
+		std::vector<double> values_;
+	};
+
+	struct pagerank_options {
+		double damping = 0.85;
+		// Iteration stops once the L1 change in the scores falls below this.
+		double tolerance = 1e-9;
+		std::size_t max_iterations = 100;
+		unsigned threads = detail::default_threads();
+	};
+
+	struct pagerank_result {
+		// Indexed by csr_view node ID. Sums to one.
+		std::vector<double> scores;
+		std::size_t iterations;
+		bool converged;
+	};
+
+	namespace detail {
+		template<typename N, typename E>
+		auto pagerank(csr_view<N, E> const& g,
+		              std::vector<double> teleport,
+		              pagerank_options const& options) -> pagerank_result {
+			if constexpr (std::is_signed_v<E>) {
+				auto const& weights = g.forward().weights;
+				if (std::any_of(weights.begin(), weights.end(), [](E w) { return w < E{0}; })) {
+					throw std::runtime_error("Cannot call gdwg::pagerank on a graph with negative edge "
+					                         "weights");
+				}
+			}
+			auto const n = std::size_t{g.node_count()};
+			auto result = pagerank_result{teleport, 0, n == 0};
+			if (n == 0) {
+				return result;
+			}
+
+			auto const matrix = sparse_matrix::transition(g);
+			auto const& out = g.forward();
+			auto dangling = std::vector<sparse_matrix::index>();
+			for (auto u = sparse_matrix::index{0}; u < n; ++u) {
+				auto const weights = out.weights_of(u);
+				if (std::accumulate(weights.begin(), weights.end(), 0.0) == 0.0) {
+					dangling.push_back(u);
+				}
+			}
+
+			// Both buffers are allocated once and swapped each iteration. Rank held by nodes with
+			// no outgoing weight is handed out along the teleport vector.
+			auto next = std::vector<double>(n);
+			auto const d = options.damping;
+			while (result.iterations < options.max_iterations and not result.converged) {
+				auto dangling_rank = 0.0;
+				for (auto const u : dangling) {
+					dangling_rank += result.scores[u];
+				}
+				auto const finish = [&](std::size_t v, double pulled) {
+					return d * pulled + (d * dangling_rank + (1.0 - d)) * teleport[v];
+				};
+				auto const change = matrix.multiply(result.scores, next, options.threads, finish);
+				result.scores.swap(next);
+				++result.iterations;
+				result.converged = change < options.tolerance;
+			}
+			return result;
+		}
+	} // namespace detail
+
+	// Pull-based weighted PageRank: each edge u -> v passes rank in proportion to its share of the
+	// total weight leaving u.
+	template<concepts::regular N, concepts::regular E>
+	requires std::is_arithmetic_v<E> //
+	   auto pagerank(csr_view<N, E> const& g, pagerank_options const& options = {})
+	      -> pagerank_result {
+		auto const n = std::size_t{g.node_count()};
+		return detail::pagerank(g, std::vector<double>(n, 1.0 / static_cast<double>(n)), options);
+	}
+
+	// PageRank where every teleport, including from nodes with no outgoing weight, lands on one of
+	// the seeds with equal probability.
+	template<concepts::regular N, concepts::regular E>
+	requires std::is_arithmetic_v<E> //
+	   auto personalized_pagerank(csr_view<N, E> const& g,
+	                              std::vector<N> const& seeds,
+	                              pagerank_options const& options = {}) -> pagerank_result {
+		if (seeds.empty()) {
+			throw std::runtime_error("Cannot call gdwg::personalized_pagerank without seeds");
+		}
+		auto teleport = std::vector<double>(g.node_count());
+		for (auto const& seed : seeds) {
+			if (not g.is_node(seed)) {
+				throw std::runtime_error("Cannot call gdwg::personalized_pagerank if a seed doesn't "
+				                         "exist in the graph");
+			}
+			teleport[g.id(seed)] += 1.0 / static_cast<double>(seeds.size());
+		}
+		return detail::pagerank(g, std::move(teleport), options);
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_PAGERANK_HPP
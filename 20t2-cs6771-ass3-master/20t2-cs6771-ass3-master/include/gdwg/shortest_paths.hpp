@@ -0,0 +1,313 @@
+#ifndef GDWG_SHORTEST_PATHS_HPP
+#define GDWG_SHORTEST_PATHS_HPP
+
+#include "gdwg/csr_view.hpp"
+#include "gdwg/detail/dary_heap.hpp"
+#include "gdwg/detail/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// Distances and parent links from one source, indexed by the csr_view's node IDs. It refers to
+	// the view it was computed on, which must outlive it.
+	template<concepts::regular N, concepts::regular E>
+	requires std::is_arithmetic_v<E> //
+	   class shortest_path_tree {
+	public:
+		using node_id = typename csr_view<N, E>::node_id;
+		static constexpr auto unreachable = std::numeric_limits<E>::max();
+		static constexpr auto no_parent = std::numeric_limits<node_id>::max();
+
+		shortest_path_tree(csr_view<N, E> const& view,
+		                   node_id source,
+		                   std::vector<E> distances,
+		                   std::vector<node_id> parents) noexcept
+		: view_{&view}
+		, source_{source}
+		, distances_{std::move(distances)}
+		, parents_{std::move(parents)} {}
+
+		[[nodiscard]] auto source() const noexcept -> N const& {
+			return view_->node(source_);
+		}
+
+		[[nodiscard]] auto reachable(N const& dst) const -> bool {
+			return distances_[view_->id(dst)] != unreachable;
+		}
+
+		// unreachable if there is no path to dst.
+		[[nodiscard]] auto distance(N const& dst) const -> E {
+			return distances_[view_->id(dst)];
+		}
+
+		// The nodes on a shortest path from the source to dst, including both ends. Empty if there
+		// is no path.
+		[[nodiscard]] auto path_to(N const& dst) const -> std::vector<N> {
+			auto id = view_->id(dst);
+			auto result = std::vector<N>();
+			if (distances_[id] == unreachable) {
+				return result;
+			}
+			for (; id != no_parent; id = parents_[id]) {
+				result.push_back(view_->node(id));
+			}
+			std::reverse(std::begin(result), std::end(result));
+			return result;
+		}
+
+		[[nodiscard]] auto distances() const noexcept -> std::span<E const> {
+			return distances_;
+		}
+
+		[[nodiscard]] auto parents() const noexcept -> std::span<node_id const> {
+			return parents_;
+		}
+
+	private:
+		csr_view<N, E> const* view_;
+		node_id source_;
+		std::vector<E> distances_;
+		std::vector<node_id> parents_;
+	};
+
+	namespace detail {
+		template<typename N, typename E>
+		auto check_shortest_paths_input(csr_view<N, E> const& g, N const& source, char const* caller)
+		   -> void {
+			if (not g.is_node(source)) {
+				throw std::runtime_error(std::string("Cannot call gdwg::") + caller
+				                         + " if source doesn't exist in the graph");
+			}
+			if constexpr (std::is_signed_v<E>) {
+				auto const& weights = g.forward().weights;
+				auto const negative = [](E w) { return w < E{0}; };
+				if (std::any_of(std::cbegin(weights), std::cend(weights), negative)) {
+					throw std::runtime_error(std::string("Cannot call gdwg::") + caller
+					                         + " on a graph with negative edge weights");
+				}
+			}
+		}
+
+		template<typename N, typename E>
+		auto dijkstra(csr_view<N, E> const& g, N const& source, N const* target)
+		   -> shortest_path_tree<N, E> {
+			using tree = shortest_path_tree<N, E>;
+			using node_id = typename tree::node_id;
+			check_shortest_paths_input(g, source, "dijkstra");
+
+			auto const s = g.id(source);
+			auto const t = target == nullptr ? tree::no_parent : g.id(*target);
+			auto distances = std::vector<E>(g.node_count(), tree::unreachable);
+			auto parents = std::vector<node_id>(g.node_count(), tree::no_parent);
+			auto const& out = g.forward();
+
+			// Entries are never updated in place. A node that is reached again by a shorter path
+			// gets a second entry, and the stale one is skipped when it is popped.
+			auto queue = dary_heap<std::pair<E, node_id>>();
+			distances[s] = E{0};
+			queue.push({E{0}, s});
+			while (not queue.empty()) {
+				auto const [d, u] = queue.top();
+				queue.pop();
+				if (d != distances[u]) {
+					continue;
+				}
+				if (u == t) {
+					break;
+				}
+				for (auto e = out.offsets[u]; e < out.offsets[u + 1]; ++e) {
+					auto const v = out.neighbours[e];
+					auto const candidate = static_cast<E>(d + out.weights[e]);
+					if (candidate < distances[v]) {
+						distances[v] = candidate;
+						parents[v] = u;
+						queue.push({candidate, v});
+					}
+				}
+			}
+			return tree(g, s, std::move(distances), std::move(parents));
+		}
+	} // namespace detail
+
+	template<concepts::regular N, concepts::regular E>
+	requires std::is_arithmetic_v<E> //
+	   auto dijkstra(csr_view<N, E> const& g, N const& source) -> shortest_path_tree<N, E> {
+		return detail::dijkstra(g, source, static_cast<N const*>(nullptr));
+	}
+
+	// Stops as soon as target's distance is final. Only target and the nodes on its path are
+	// guaranteed to have their final distances and parents.
+	template<concepts::regular N, concepts::regular E>
+	requires std::is_arithmetic_v<E> //
+	   auto dijkstra(csr_view<N, E> const& g, N const& source, N const& target)
+	      -> shortest_path_tree<N, E> {
+		if (not g.is_node(target)) {
+			throw std::runtime_error("Cannot call gdwg::dijkstra if target doesn't exist in the "
+			                         "graph");
+		}
+		return detail::dijkstra(g, source, &target);
+	}
+
+	// Parallel delta-stepping. Nodes are kept in buckets of width delta and each bucket is settled
+	// in rounds: every round relaxes the light edges (weight <= delta) of the bucket's frontier
+	// across `threads` threads, and heavy edges are relaxed once when the bucket empties. A delta
+	// close to the average edge weight is usually a good start. Produces the same distances as
+	// dijkstra; where several shortest paths exist, each node's parent is its lowest-ID
+	// predecessor on one of them that is strictly closer to the source. Nodes reached only across
+	// zero-weight edges take a predecessor at the same distance instead, chosen so that the parent
+	// links never form a cycle.
+	template<concepts::regular N, concepts::regular E>
+	requires std::is_arithmetic_v<E> //
+	   auto delta_stepping(csr_view<N, E> const& g,
+	                       N const& source,
+	                       E delta,
+	                       unsigned threads = detail::default_threads())
+	      -> shortest_path_tree<N, E> {
+		using tree = shortest_path_tree<N, E>;
+		using node_id = typename tree::node_id;
+		detail::check_shortest_paths_input(g, source, "delta_stepping");
+		if (not(delta > E{0})) {
+			throw std::runtime_error("Cannot call gdwg::delta_stepping with a delta that isn't "
+			                         "positive");
+		}
+
+		auto const s = g.id(source);
+		auto const& out = g.forward();
+		auto distances = std::vector<E>(g.node_count(), tree::unreachable);
+		distances[s] = E{0};
+		// Buckets are keyed sparsely, so a small delta costs nothing for the empty ones. Distances
+		// too large to index share the last bucket, which is settled in rounds like any other.
+		constexpr auto last_bucket = std::size_t{1} << 62U;
+		auto const bucket_of = [delta](E d) {
+			auto const b = d / delta;
+			if constexpr (std::is_floating_point_v<E>) {
+				if (not(b < static_cast<E>(last_bucket))) {
+					return last_bucket;
+				}
+			}
+			return static_cast<std::size_t>(b);
+		};
+		auto buckets = std::map<std::size_t, std::vector<node_id>>{{0, {s}}};
+		auto improved = std::vector<std::vector<node_id>>(std::max(threads, 1U));
+
+		auto const relax = [&](std::vector<node_id> const& frontier, bool light) {
+			auto const relax_block = [&](std::size_t first, std::size_t last, unsigned thread) {
+				for (auto i = first; i < last; ++i) {
+					auto const u = frontier[i];
+					auto const d = std::atomic_ref<E>(distances[u]).load();
+					for (auto e = out.offsets[u]; e < out.offsets[u + 1]; ++e) {
+						if ((out.weights[e] <= delta) != light) {
+							continue;
+						}
+						auto const v = out.neighbours[e];
+						auto const candidate = static_cast<E>(d + out.weights[e]);
+						auto target = std::atomic_ref<E>(distances[v]);
+						auto current = target.load();
+						while (candidate < current) {
+							if (target.compare_exchange_weak(current, candidate)) {
+								improved[thread].push_back(v);
+								break;
+							}
+						}
+					}
+				}
+			};
+			detail::parallel_for(threads, std::size(frontier), relax_block);
+
+			for (auto& nodes : improved) {
+				for (auto const v : nodes) {
+					buckets[bucket_of(distances[v])].push_back(v);
+				}
+				nodes.clear();
+			}
+		};
+
+		while (not buckets.empty()) {
+			auto const i = std::begin(buckets)->first;
+			auto& bucket = std::begin(buckets)->second;
+			auto settled = std::vector<node_id>();
+			while (not bucket.empty()) {
+				auto frontier = std::exchange(bucket, {});
+				std::erase_if(frontier, [&](node_id v) { return bucket_of(distances[v]) != i; });
+				std::sort(std::begin(frontier), std::end(frontier));
+				frontier.erase(std::unique(std::begin(frontier), std::end(frontier)),
+				               std::end(frontier));
+				relax(frontier, true);
+				settled.insert(std::end(settled), std::cbegin(frontier), std::cend(frontier));
+			}
+			std::sort(std::begin(settled), std::end(settled));
+			settled.erase(std::unique(std::begin(settled), std::end(settled)), std::end(settled));
+			buckets.erase(i);
+			relax(settled, false);
+		}
+
+		// Every final distance was written as some predecessor's final distance plus an edge
+		// weight, so parents can be recovered exactly from the edges where that sum holds. A
+		// predecessor strictly closer to the source can't lead back to v, so those are taken
+		// first.
+		auto parents = std::vector<node_id>(g.node_count(), tree::no_parent);
+		auto const tight = [&distances](node_id u, E weight, node_id v) {
+			return distances[u] != tree::unreachable
+			       and static_cast<E>(distances[u] + weight) == distances[v];
+		};
+		auto const& in = g.reverse();
+		auto const find_parents = [&](std::size_t first, std::size_t last, unsigned) {
+			for (auto v = static_cast<node_id>(first); v < last; ++v) {
+				if (v == s or distances[v] == tree::unreachable) {
+					continue;
+				}
+				for (auto e = in.offsets[v]; e < in.offsets[v + 1]; ++e) {
+					auto const u = in.neighbours[e];
+					if (distances[u] < distances[v] and tight(u, in.weights[e], v)) {
+						parents[v] = u;
+						break;
+					}
+				}
+			}
+		};
+		detail::parallel_for(threads, g.node_count(), find_parents);
+
+		// The rest were only reached across edges that didn't change the distance, such as
+		// zero-weight ones. Each takes, breadth first, a predecessor that already has its path.
+		auto const orphan = [&](node_id v) {
+			return v != s and distances[v] != tree::unreachable and parents[v] == tree::no_parent;
+		};
+		auto queue = std::vector<node_id>();
+		auto orphans = false;
+		for (auto v = node_id{0}; v < g.node_count(); ++v) {
+			if (orphan(v)) {
+				orphans = true;
+			}
+			else if (distances[v] != tree::unreachable) {
+				queue.push_back(v);
+			}
+		}
+		if (orphans) {
+			for (auto i = std::size_t{0}; i < std::size(queue); ++i) {
+				auto const u = queue[i];
+				for (auto e = out.offsets[u]; e < out.offsets[u + 1]; ++e) {
+					auto const v = out.neighbours[e];
+					if (orphan(v) and tight(u, out.weights[e], v)) {
+						parents[v] = u;
+						queue.push_back(v);
+					}
+				}
+			}
+		}
+		return tree(g, s, std::move(distances), std::move(parents));
+	}
+
+} // namespace gdwg
+
+#endif // GDWG_SHORTEST_PATHS_HPP
@@ -0,0 +1,131 @@
+#ifndef GDWG_SLAB_RESOURCE_HPP
+#define GDWG_SLAB_RESOURCE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+namespace gdwg {
+
+	// A single-threaded memory resource for the many small, equally sized blocks a graph's sets
+	// allocate. Blocks are carved from large chunks by bumping a pointer, and a freed block goes
+	// onto a free list for its size, so allocating is a pointer bump or a list pop and
+	// deallocating is a list push. Chunks only go back upstream in release() or the destructor,
+	// which costs one upstream call per chunk no matter how many blocks were handed out. Blocks
+	// larger than max_block_size, or more strictly aligned than granularity, are passed straight
+	// to upstream.
+	class slab_resource : public std::pmr::memory_resource {
+	public:
+		static constexpr auto granularity = alignof(std::max_align_t);
+		static constexpr auto max_block_size = std::size_t{512};
+
+		explicit slab_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+		                       std::size_t initial_chunk_size = std::size_t{64} * 1024) noexcept
+		: upstream_{upstream}
+		, next_chunk_size_{std::max(initial_chunk_size, max_block_size + sizeof(chunk))} {}
+
+		slab_resource(slab_resource const&) = delete;
+		auto operator=(slab_resource const&) -> slab_resource& = delete;
+
+		~slab_resource() override {
+			release();
+		}
+
+		// Returns every chunk upstream. Anything still using memory from this resource must
+		// already be gone.
+		auto release() noexcept -> void {
+			while (chunks_ != nullptr) {
+				auto* const next = chunks_->next;
+				upstream_->deallocate(chunks_, chunks_->size, granularity);
+				chunks_ = next;
+			}
+			free_.fill(nullptr);
+			cursor_ = nullptr;
+			end_ = nullptr;
+			reserved_ = 0;
+		}
+
+		[[nodiscard]] auto upstream() const noexcept -> std::pmr::memory_resource* {
+			return upstream_;
+		}
+
+		// The total size of the chunks taken from upstream.
+		[[nodiscard]] auto bytes_reserved() const noexcept -> std::size_t {
+			return reserved_;
+		}
+
+	private:
+		struct free_block {
+			free_block* next;
+		};
+
+		// Sits at the start of each chunk.
+		struct alignas(granularity) chunk {
+			chunk* next;
+			std::size_t size;
+		};
+
+		static auto size_class(std::size_t bytes) noexcept -> std::size_t {
+			return (std::max(bytes, std::size_t{1}) + granularity - 1) / granularity;
+		}
+
+		static auto is_small(std::size_t bytes, std::size_t alignment) noexcept -> bool {
+			return bytes <= max_block_size and alignment <= granularity;
+		}
+
+		auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+			if (not is_small(bytes, alignment)) {
+				return upstream_->allocate(bytes, alignment);
+			}
+			auto const c = size_class(bytes);
+			if (auto* const block = free_[c]) {
+				free_[c] = block->next;
+				return block;
+			}
+			auto const size = c * granularity;
+			if (static_cast<std::size_t>(end_ - cursor_) < size) {
+				add_chunk();
+			}
+			auto* const block = cursor_;
+			cursor_ += size;
+			return block;
+		}
+
+		auto do_deallocate(void* p, std::size_t bytes, std::size_t alignment) -> void override {
+			if (not is_small(bytes, alignment)) {
+				upstream_->deallocate(p, bytes, alignment);
+				return;
+			}
+			auto const c = size_class(bytes);
+			free_[c] = ::new (p) free_block{free_[c]};
+		}
+
+		[[nodiscard]] auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+		   -> bool override {
+			return this == &other;
+		}
+
+		// The unused tail of the current chunk is abandoned. Each chunk is twice the size of the
+		// one before.
+		auto add_chunk() -> void {
+			auto* const memory = upstream_->allocate(next_chunk_size_, granularity);
+			chunks_ = ::new (memory) chunk{chunks_, next_chunk_size_};
+			reserved_ += next_chunk_size_;
+			cursor_ = static_cast<std::byte*>(memory) + sizeof(chunk);
+			end_ = static_cast<std::byte*>(memory) + next_chunk_size_;
+			next_chunk_size_ *= 2;
+		}
+
+		std::pmr::memory_resource* upstream_;
+		std::size_t next_chunk_size_;
+		std::array<free_block*, max_block_size / granularity + 1> free_ = {};
+		chunk* chunks_ = nullptr;
+		std::byte* cursor_ = nullptr;
+		std::byte* end_ = nullptr;
+		std::size_t reserved_ = 0;
+	};
+
+} // namespace gdwg
+
+#endif // GDWG_SLAB_RESOURCE_HPP
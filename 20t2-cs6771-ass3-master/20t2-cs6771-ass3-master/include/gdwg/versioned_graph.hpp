@@ -0,0 +1,329 @@
+#ifndef GDWG_VERSIONED_GRAPH_HPP
+#define GDWG_VERSIONED_GRAPH_HPP
+
+#include "gdwg/detail/persistent_adjacency.hpp"
+#include "gdwg/detail/persistent_map.hpp"
+#include "gdwg/graph.hpp"
+
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <range/v3/utility.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+
+	// One immutable version of a versioned_graph. Copying it is O(1): versions share every part of
+	// their structure that hasn't changed between them, and each part is freed once no version
+	// uses it. A snapshot can be read on any thread while the versioned_graph it came from keeps
+	// changing on another.
+	template<concepts::regular N, concepts::regular E>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   class graph_snapshot {
+	public:
+		class iterator;
+		using value_type = typename graph<N, E>::value_type;
+
+		graph_snapshot() noexcept = default;
+
+		[[nodiscard]] auto is_node(N const& value) const -> bool {
+			return nodes_.contains(value);
+		}
+
+		[[nodiscard]] auto empty() const -> bool {
+			return nodes_.empty();
+		}
+
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			if (is_node(src) and is_node(dst)) {
+				return nodes_.at(src).out.contains(dst);
+			}
+			throw std::runtime_error("Cannot call gdwg::graph_snapshot<N, E>::is_connected if src or "
+			                         "dst node don't exist in the graph");
+		}
+
+		[[nodiscard]] auto nodes() const -> std::vector<N> {
+			auto result = std::vector<N>();
+			result.reserve(nodes_.size());
+			for (auto const& x : nodes_) {
+				result.push_back(x.key);
+			}
+			return result;
+		}
+
+		[[nodiscard]] auto weights(N const& src, N const& dst) const -> std::vector<E> {
+			if (is_node(src) and is_node(dst)) {
+				return adjacency::weights(nodes_.at(src).out, dst);
+			}
+			throw std::runtime_error("Cannot call gdwg::graph_snapshot<N, E>::weights if src or dst "
+			                         "node don't exist in the graph");
+		}
+
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+			if (is_node(src)) {
+				return adjacency::neighbours(nodes_.at(src).out);
+			}
+			throw std::runtime_error("Cannot call gdwg::graph_snapshot<N, E>::connections if src "
+			                         "doesn't exist in the graph");
+		}
+
+		[[nodiscard]] auto connections_to(N const& dst) const -> std::vector<N> {
+			if (is_node(dst)) {
+				return adjacency::neighbours(nodes_.at(dst).in);
+			}
+			throw std::runtime_error("Cannot call gdwg::graph_snapshot<N, E>::connections_to if dst "
+			                         "doesn't exist in the graph");
+		}
+
+		// A regular graph with the same nodes and edges.
+		[[nodiscard]] auto to_graph() const -> graph<N, E> {
+			auto edges = std::vector<value_type>();
+			for (auto const& e : *this) {
+				edges.push_back(value_type{std::get<0>(e), std::get<1>(e), std::get<2>(e)});
+			}
+			auto result = graph<N, E>(std::cbegin(edges), std::cend(edges));
+			auto const values = nodes();
+			result.insert_nodes(std::cbegin(values), std::cend(values));
+			return result;
+		}
+
+		// Visits (from, to, weight) in the same order as graph::iterator.
+		[[nodiscard]] auto begin() const -> iterator {
+			return iterator(nodes_.begin(), nodes_.end());
+		}
+
+		[[nodiscard]] auto end() const -> iterator {
+			return iterator(nodes_.end(), nodes_.end());
+		}
+
+	protected:
+		using adjacency = detail::persistent_adjacency<N, E>;
+		using node_map = detail::persistent_map<N, adjacency>;
+
+		node_map nodes_;
+
+	public:
+		class iterator {
+		public:
+			using value_type = ranges::common_tuple<N, N, E>;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			iterator() = default;
+
+			auto operator*() const -> ranges::common_tuple<N const&, N const&, E const&> {
+				return ranges::common_tuple<N const&, N const&, E const&>(node_->key,
+				                                                          edge_->key,
+				                                                          weight_->key);
+			}
+
+			auto operator++() -> iterator& {
+				++weight_;
+				if (weight_ == edge_->value.end()) {
+					++edge_;
+					settle();
+				}
+				return *this;
+			}
+			auto operator++(int) -> iterator {
+				auto tmp = *this;
+				++*this;
+				return tmp;
+			}
+
+			auto operator==(iterator const& other) const -> bool {
+				return node_ == other.node_ and (node_ == last_ or weight_ == other.weight_);
+			}
+
+		private:
+			friend class graph_snapshot<N, E>;
+			using node_iterator = typename node_map::iterator;
+			using edge_iterator = typename adjacency::edge_map::iterator;
+			using weight_iterator = typename adjacency::weight_set::iterator;
+
+			iterator(node_iterator first, node_iterator last)
+			: node_{std::move(first)}
+			, last_{std::move(last)} {
+				if (node_ != last_) {
+					edge_ = node_->value.out.begin();
+					settle();
+				}
+			}
+
+			// Moves forward from edge_ to the next edge, starting a new node where needed.
+			auto settle() -> void {
+				while (edge_ == node_->value.out.end()) {
+					if (++node_ == last_) {
+						return;
+					}
+					edge_ = node_->value.out.begin();
+				}
+				weight_ = edge_->value.begin();
+			}
+
+			node_iterator node_;
+			node_iterator last_;
+			edge_iterator edge_;
+			weight_iterator weight_;
+		};
+	};
+
+	// A graph whose snapshot() is O(1). Each modifier makes a new version that shares all
+	// unchanged structure with the previous one, at O(log n) extra allocations per change; a
+	// version lives as long as the versioned_graph or some snapshot still holds it. Modifiers and
+	// snapshot() must not run concurrently with each other.
+	template<concepts::regular N, concepts::regular E>
+	requires concepts::totally_ordered<N> //
+	   and concepts::totally_ordered<E> //
+	   class versioned_graph : public graph_snapshot<N, E> {
+		using base = graph_snapshot<N, E>;
+		using typename base::adjacency;
+		using base::nodes_;
+
+	public:
+		versioned_graph() noexcept = default;
+
+		versioned_graph(std::initializer_list<N> il) {
+			for (auto const& x : il) {
+				insert_node(x);
+			}
+		}
+
+		explicit versioned_graph(graph<N, E> const& g) {
+			for (auto const& x : g.nodes()) {
+				insert_node(x);
+			}
+			for (auto const& e : g) {
+				insert_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+			}
+		}
+
+		[[nodiscard]] auto snapshot() const noexcept -> graph_snapshot<N, E> {
+			return graph_snapshot<N, E>(*this);
+		}
+
+		auto insert_node(N const& value) -> bool {
+			if (this->is_node(value)) {
+				return false;
+			}
+			nodes_ = nodes_.insert_or_assign(value, adjacency{});
+			return true;
+		}
+
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			if (this->is_node(src) and this->is_node(dst)) {
+				if (has_edge(src, dst, weight)) {
+					return false;
+				}
+				update(src, dst, weight, true);
+				return true;
+			}
+			throw std::runtime_error("Cannot call gdwg::versioned_graph<N, E>::insert_edge when "
+			                         "either src or dst node does not exist");
+		}
+
+		auto replace_node(N const& old_data, N const& new_data) -> bool {
+			if (this->is_node(old_data)) {
+				if (this->is_node(new_data)) {
+					return false;
+				}
+				insert_node(new_data);
+				merge_replace_node(old_data, new_data);
+				return true;
+			}
+			throw std::runtime_error("Cannot call gdwg::versioned_graph<N, E>::replace_node on a node "
+			                         "that doesn't exist");
+		}
+
+		auto merge_replace_node(N const& old_data, N const& new_data) -> void {
+			if (not this->is_node(old_data) or not this->is_node(new_data)) {
+				throw std::runtime_error("Cannot call gdwg::versioned_graph<N, E>::merge_replace_node "
+				                         "on old or new data if they don't exist in the graph");
+			}
+			if (old_data == new_data) {
+				return;
+			}
+			auto const old_node = nodes_.at(old_data);
+			erase_node(old_data);
+			auto const redirect = [&](N const& x) -> N const& {
+				return x == old_data ? new_data : x;
+			};
+			for (auto const& [to, weights] : old_node.out) {
+				for (auto const& w : weights) {
+					insert_edge(new_data, redirect(to), w.key);
+				}
+			}
+			for (auto const& [from, weights] : old_node.in) {
+				for (auto const& w : weights) {
+					insert_edge(redirect(from), new_data, w.key);
+				}
+			}
+		}
+
+		auto erase_node(N const& value) -> bool {
+			auto const* found = nodes_.find(value);
+			if (found == nullptr) {
+				return false;
+			}
+			auto const removed = *found;
+			nodes_ = nodes_.erase(value);
+			for (auto const& x : removed.out) {
+				if (x.key != value) {
+					auto a = nodes_.at(x.key);
+					a.in = a.in.erase(value);
+					nodes_ = nodes_.insert_or_assign(x.key, std::move(a));
+				}
+			}
+			for (auto const& x : removed.in) {
+				if (x.key != value) {
+					auto a = nodes_.at(x.key);
+					a.out = a.out.erase(value);
+					nodes_ = nodes_.insert_or_assign(x.key, std::move(a));
+				}
+			}
+			return true;
+		}
+
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			if (this->is_node(src) and this->is_node(dst)) {
+				if (not has_edge(src, dst, weight)) {
+					return false;
+				}
+				update(src, dst, weight, false);
+				return true;
+			}
+			throw std::runtime_error("Cannot call gdwg::versioned_graph<N, E>::erase_edge on src or "
+			                         "dst if they don't exist in the graph");
+		}
+
+		auto clear() noexcept -> void {
+			nodes_ = {};
+		}
+
+	private:
+		[[nodiscard]] auto has_edge(N const& src, N const& dst, E const& weight) const -> bool {
+			return adjacency::contains(nodes_.at(src).out, dst, weight);
+		}
+
+		auto update(N const& src, N const& dst, E const& weight, bool add) -> void {
+			auto from = nodes_.at(src);
+			from.out = adjacency::toggle(from.out, dst, weight, add);
+			if (src == dst) {
+				from.in = adjacency::toggle(from.in, src, weight, add);
+				nodes_ = nodes_.insert_or_assign(src, std::move(from));
+				return;
+			}
+			auto to = nodes_.at(dst);
+			to.in = adjacency::toggle(to.in, src, weight, add);
+			nodes_ =
+			   nodes_.insert_or_assign(src, std::move(from)).insert_or_assign(dst, std::move(to));
+		}
+	};
+
+} // namespace gdwg
+
+#endif // GDWG_VERSIONED_GRAPH_HPP
@@ -0,0 +1,108 @@
+#include "gdwg/bfs.hpp"
+
+#include "gdwg/csr_view.hpp"
+#include "gdwg/graph.hpp"
+#include "random_graph.hpp"
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto make_graph() -> gdwg::graph<std::string, int> {
+		using graph = gdwg::graph<std::string, int>;
+		auto const v = std::vector<graph::value_type>{
+		   {"a", "b", 1},
+		   {"a", "c", 1},
+		   {"b", "d", 1},
+		   {"c", "d", 1},
+		   {"d", "e", 1},
+		   {"f", "a", 1},
+		   {"g", "h", 1},
+		};
+		return graph(v.begin(), v.end());
+	}
+
+	auto make_random_graph(int nodes, int edges) -> gdwg::graph<int, int> {
+		return gdwg::test::make_random_graph(nodes, edges, [](std::mt19937&) { return 1; });
+	}
+
+	constexpr auto unreachable = gdwg::bfs_tree<int, int>::unreachable;
+
+	auto serial_distances(gdwg::csr_view<int, int> const& csr, int source)
+	   -> std::vector<std::uint32_t> {
+		auto distances = std::vector<std::uint32_t>(csr.node_count(), unreachable);
+		auto queue = std::deque<std::uint32_t>{csr.id(source)};
+		distances[queue.front()] = 0;
+		while (not queue.empty()) {
+			auto const u = queue.front();
+			queue.pop_front();
+			for (auto const v : csr.forward().neighbours_of(u)) {
+				if (distances[v] == unreachable) {
+					distances[v] = distances[u] + 1;
+					queue.push_back(v);
+				}
+			}
+		}
+		return distances;
+	}
+} // namespace
+
+TEST_CASE("bfs") {
+	auto const csr = gdwg::freeze(make_graph());
+
+	SECTION("single source") {
+		auto const tree = gdwg::bfs(csr, std::string("a"));
+		CHECK(tree.distance("a") == 0);
+		CHECK(tree.distance("d") == 2);
+		CHECK(tree.distance("e") == 3);
+		CHECK_FALSE(tree.reachable("f"));
+		CHECK(tree.path_to("a") == std::vector<std::string>{"a"});
+		CHECK(std::size(tree.path_to("e")) == 4);
+		CHECK(std::empty(tree.path_to("h")));
+		CHECK(tree.reached() == std::vector<std::string>{"a", "b", "c", "d", "e"});
+	}
+
+	SECTION("multiple sources") {
+		auto const tree = gdwg::bfs(csr, std::vector<std::string>{"d", "g", "d"});
+		CHECK(tree.distance("e") == 1);
+		CHECK(tree.distance("h") == 1);
+		CHECK(tree.path_to("h") == std::vector<std::string>{"g", "h"});
+		CHECK_FALSE(tree.reachable("a"));
+		CHECK(gdwg::reachable_from(csr, std::vector<std::string>{"f", "g"})
+		      == std::vector<std::string>{"a", "b", "c", "d", "e", "f", "g", "h"});
+	}
+
+	SECTION("missing source") {
+		CHECK_THROWS_MATCHES(gdwg::bfs(csr, std::string("z")),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::bfs if a source doesn't "
+		                                              "exist in the graph"));
+	}
+}
+
+// Dense graphs switch to bottom-up within a level or two, and sparse ones stay top-down.
+TEST_CASE("bfs matches a serial search in both directions") {
+	for (auto const edges : {3000, 60000}) {
+		auto const csr = gdwg::freeze(make_random_graph(3000, edges));
+		auto const expected = serial_distances(csr, 0);
+		for (auto const threads : {1U, 4U}) {
+			auto const tree = gdwg::bfs(csr, 0, threads);
+			auto const actual = tree.distances();
+			REQUIRE(std::equal(expected.begin(), expected.end(), actual.begin(), actual.end()));
+			for (auto v = std::uint32_t{1}; v < csr.node_count(); ++v) {
+				auto const parent = tree.parents()[v];
+				if (actual[v] == unreachable) {
+					CHECK(parent == gdwg::bfs_tree<int, int>::no_parent);
+				}
+				else {
+					CHECK(actual[parent] + 1 == actual[v]);
+					CHECK(csr.is_connected(csr.node(parent), csr.node(v)));
+				}
+			}
+		}
+	}
+}
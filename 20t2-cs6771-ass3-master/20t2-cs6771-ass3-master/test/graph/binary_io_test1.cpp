@@ -0,0 +1,235 @@
+#include "gdwg/binary_io.hpp"
+
+#include "gdwg/csr_view.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/slab_resource.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto bytes_of(std::string const& s) -> std::vector<std::byte> {
+		auto result = std::vector<std::byte>();
+		for (auto const c : s) {
+			result.push_back(static_cast<std::byte>(c));
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	auto encode(gdwg::graph<N, E> const& g) -> std::vector<std::byte> {
+		auto out = std::ostringstream();
+		gdwg::write_graph(out, g);
+		return bytes_of(out.str());
+	}
+
+	auto make_graph() -> gdwg::graph<std::string, double> {
+		using graph = gdwg::graph<std::string, double>;
+		auto const v = std::vector<graph::value_type>{
+		   {"b", "a", 3.5},
+		   {"a", "c", -2},
+		   {"a", "b", 7},
+		   {"a", "b", 1},
+		   {"c", "a", 4},
+		   {"c", "c", 5.25},
+		};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node("d");
+		g.insert_node("");
+		return g;
+	}
+
+	// Stores each node as its length only, so names must differ in length.
+	struct length_serializer {
+		auto write(gdwg::binary_writer& out, std::string const& value) const -> void {
+			out.varint(value.size());
+		}
+
+		auto read(gdwg::binary_reader& in) const -> std::string {
+			return std::string(static_cast<std::size_t>(in.varint()), 'x');
+		}
+	};
+} // namespace
+
+TEST_CASE("Graphs round-trip through the binary format") {
+	SECTION("strings and doubles") {
+		auto const g = make_graph();
+		auto const data = encode(g);
+		auto const h = gdwg::read_graph<std::string, double>(data);
+		CHECK(h == g);
+		CHECK(h.is_node("d"));
+		CHECK(h.weights("a", "b") == std::vector<double>{1, 7});
+		CHECK(h.connections_to("a") == std::vector<std::string>{"b", "c"});
+	}
+
+	SECTION("an empty graph") {
+		auto const g = gdwg::graph<int, int>();
+		CHECK(gdwg::read_graph<int, int>(encode(g)).empty());
+		CHECK(gdwg::read_csr<int, int>(encode(g)).empty());
+	}
+
+	SECTION("integer extremes") {
+		using limits = std::numeric_limits<std::int64_t>;
+		auto g = gdwg::graph<std::int64_t, std::int64_t>{limits::min(), -1, 0, limits::max()};
+		g.insert_edge(limits::min(), limits::max(), limits::min());
+		g.insert_edge(limits::max(), limits::min(), limits::max());
+		g.insert_edge(-1, 0, -1);
+		CHECK(gdwg::read_graph<std::int64_t, std::int64_t>(encode(g)) == g);
+	}
+
+	SECTION("a random graph, into a memory resource") {
+		auto rng = std::mt19937(6771);
+		auto node = std::uniform_int_distribution<int>(-500, 500);
+		auto g = gdwg::graph<int, int>();
+		for (auto i = -500; i <= 500; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i < 20000; ++i) {
+			g.insert_edge(node(rng), node(rng), node(rng));
+		}
+		auto slab = gdwg::slab_resource();
+		auto const h = gdwg::read_graph<int, int>(encode(g), {}, {}, &slab);
+		CHECK(h.resource() == &slab);
+		CHECK(h == g);
+		for (auto const i : {-500, 0, 17, 500}) {
+			CHECK(h.connections(i) == g.connections(i));
+			CHECK(h.connections_to(i) == g.connections_to(i));
+		}
+	}
+
+	SECTION("with a custom serializer") {
+		auto g = gdwg::graph<std::string, int>{"a", "bb", "ccc"};
+		g.insert_edge("a", "ccc", 4);
+		auto out = std::ostringstream();
+		gdwg::write_graph(out, g, length_serializer{});
+		auto const h = gdwg::read_graph<std::string, int>(bytes_of(out.str()), length_serializer{});
+		CHECK(h.nodes() == std::vector<std::string>{"x", "xx", "xxx"});
+		CHECK(h.is_connected("x", "xxx"));
+	}
+}
+
+TEST_CASE("The binary format is compact") {
+	// A chain i -> i + 1 with weight 1 costs one byte each for the source step, the target and
+	// the weight.
+	auto g = gdwg::graph<int, int>();
+	for (auto i = 0; i < 1000; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 999; ++i) {
+		g.insert_edge(i, i + 1, 1);
+	}
+	auto const size = encode(g).size();
+	CHECK(size < 8 + 4 + 1000 * 2 + 999 * 3);
+}
+
+TEST_CASE("read_csr builds the same view as freeze") {
+	auto const g = make_graph();
+	auto const frozen = gdwg::freeze(g);
+	auto const csr = gdwg::read_csr<std::string, double>(encode(g));
+	CHECK(csr.nodes().size() == frozen.nodes().size());
+	CHECK(csr.forward().offsets == frozen.forward().offsets);
+	CHECK(csr.forward().neighbours == frozen.forward().neighbours);
+	CHECK(csr.forward().weights == frozen.forward().weights);
+	CHECK(csr.reverse().offsets == frozen.reverse().offsets);
+	CHECK(csr.reverse().neighbours == frozen.reverse().neighbours);
+	CHECK(csr.reverse().weights == frozen.reverse().weights);
+	CHECK(csr.weights("a", "b") == std::vector<double>{1, 7});
+}
+
+TEST_CASE("Corrupt data is rejected") {
+	auto const data = encode(make_graph());
+	auto const read = [](std::vector<std::byte> const& bytes) {
+		return gdwg::read_graph<std::string, double>(bytes);
+	};
+	auto const message = "Cannot call gdwg::read_graph or gdwg::read_csr on truncated or corrupt "
+	                     "data";
+
+	SECTION("every truncation") {
+		for (auto size = std::size_t{0}; size < data.size(); ++size) {
+			auto const prefix =
+			   std::vector<std::byte>(data.begin(), data.begin() + static_cast<long>(size));
+			CHECK_THROWS_WITH(read(prefix), message);
+		}
+	}
+
+	SECTION("trailing bytes, a bad magic number and a bad version") {
+		auto longer = data;
+		longer.push_back(std::byte{0});
+		CHECK_THROWS_WITH(read(longer), message);
+		auto bad_magic = data;
+		bad_magic[0] = std::byte{'g'};
+		CHECK_THROWS_WITH(read(bad_magic), message);
+		auto bad_version = data;
+		bad_version[4] = std::byte{2};
+		CHECK_THROWS_WITH(read(bad_version), message);
+	}
+
+	SECTION("nodes out of order") {
+		auto g = gdwg::graph<std::string, int>{"a", "b"};
+		auto out = std::ostringstream();
+		gdwg::write_graph(out, g, length_serializer{});
+		// "a" and "b" have the same length, so they read back as the same node twice.
+		CHECK_THROWS_WITH((gdwg::read_graph<std::string, int>(bytes_of(out.str()),
+		                                                      length_serializer{})),
+		                  message);
+	}
+
+	SECTION("an edge to a node that isn't there") {
+		auto g = gdwg::graph<int, int>{0, 1};
+		g.insert_edge(0, 1, 0);
+		auto bytes = encode(g);
+		// The last three bytes are the edge: source step 0, target 1, weight 0.
+		bytes[bytes.size() - 2] = std::byte{2};
+		CHECK_THROWS_WITH((gdwg::read_csr<int, int>(bytes)), message);
+	}
+}
+
+TEST_CASE("Integers that don't fit the type read are rejected") {
+	auto const message = "Cannot call gdwg::read_graph or gdwg::read_csr on truncated or corrupt "
+	                     "data";
+	for (auto const weight : {std::int64_t{1} << 40U, -(std::int64_t{1} << 40U)}) {
+		auto g = gdwg::graph<int, std::int64_t>{0, 1};
+		g.insert_edge(0, 1, weight);
+		auto const bytes = encode(g);
+		CHECK_THROWS_WITH((gdwg::read_graph<int, int>(bytes)), message);
+		CHECK_THROWS_WITH((gdwg::read_csr<int, int>(bytes)), message);
+		CHECK((gdwg::read_graph<int, std::int64_t>(bytes) == g));
+	}
+
+	auto wide = gdwg::graph<std::uint64_t, std::uint64_t>{0, 300};
+	wide.insert_edge(0, 0, 2);
+	auto const bytes = encode(wide);
+	CHECK_THROWS_WITH((gdwg::read_graph<std::uint8_t, std::uint64_t>(bytes)), message);
+	CHECK_THROWS_WITH((gdwg::read_graph<std::uint64_t, bool>(bytes)), message);
+}
+
+TEST_CASE("Graphs save to and load from files") {
+	auto const path = std::filesystem::temp_directory_path() / "gdwg_binary_io_test1.bin";
+	auto const g = make_graph();
+	gdwg::save_graph(path, g);
+	CHECK(gdwg::mapped_file(path).bytes().size() == encode(g).size());
+	CHECK(gdwg::load_graph<std::string, double>(path) == g);
+	CHECK(gdwg::load_csr<std::string, double>(path).edge_count() == 6);
+
+	auto moved = gdwg::mapped_file(path);
+	auto const size = moved.bytes().size();
+	auto const file = std::move(moved);
+	CHECK(file.bytes().size() == size);
+	std::filesystem::remove(path);
+
+	CHECK_THROWS_WITH(gdwg::mapped_file(path),
+	                  "Cannot call gdwg::mapped_file on " + path.string()
+	                     + ", which can't be opened");
+	auto const empty = std::filesystem::temp_directory_path() / "gdwg_binary_io_test1.empty";
+	std::ofstream(empty).close();
+	CHECK(gdwg::mapped_file(empty).bytes().empty());
+	std::filesystem::remove(empty);
+}
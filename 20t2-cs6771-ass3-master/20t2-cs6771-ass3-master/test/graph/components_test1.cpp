@@ -0,0 +1,168 @@
+#include "gdwg/components.hpp"
+
+#include "gdwg/bfs.hpp"
+#include "gdwg/csr_view.hpp"
+#include "gdwg/graph.hpp"
+#include "random_graph.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+	// An acyclic graph keeps only the edges from a lower node to a higher one.
+	auto make_random_graph(int nodes, int edges, bool acyclic) -> gdwg::graph<int, int> {
+		auto g =
+		   gdwg::test::make_random_graph(nodes, edges, std::uniform_int_distribution<int>(0, 2));
+		for (auto i = g.begin(); acyclic and i != g.end();) {
+			if (std::get<0>(*i) < std::get<1>(*i)) {
+				++i;
+			}
+			else {
+				i = g.erase_edge(i);
+			}
+		}
+		return g;
+	}
+
+	auto make_chain(int length, bool closed) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>();
+		for (auto i = 0; i < length; ++i) {
+			g.insert_node(i);
+		}
+		for (auto i = 0; i + 1 < length; ++i) {
+			g.insert_edge(i, i + 1, 1);
+		}
+		if (closed) {
+			g.insert_edge(length - 1, 0, 1);
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("strongly_connected_components") {
+	SECTION("small graph") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e", "f"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "a", 1);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("b", "c", 2);
+		g.insert_edge("c", "d", 1);
+		g.insert_edge("d", "e", 1);
+		g.insert_edge("e", "c", 1);
+		g.insert_edge("a", "e", 1);
+		auto const csr = gdwg::freeze(g);
+		auto const scc = gdwg::strongly_connected_components(csr);
+
+		CHECK(scc.count() == 3);
+		CHECK(scc.members(scc.component("a")) == std::vector<std::string>{"a", "b"});
+		CHECK(scc.members(scc.component("d")) == std::vector<std::string>{"c", "d", "e"});
+		CHECK(scc.members(scc.component("f")) == std::vector<std::string>{"f"});
+		CHECK(scc.component("a") < scc.component("c"));
+
+		auto const dag = scc.condensation();
+		CHECK(dag.nodes() == std::vector<std::uint32_t>{0, 1, 2});
+		auto const from = scc.component("a");
+		auto const to = scc.component("c");
+		CHECK(dag.connections(from) == std::vector<std::uint32_t>{to});
+		CHECK(dag.weights(from, to) == std::vector<std::size_t>{3});
+		CHECK(dag.connections(scc.component("f")).empty());
+	}
+
+	SECTION("empty graph") {
+		auto const g = gdwg::graph<int, int>();
+		auto const csr = gdwg::freeze(g);
+		auto const scc = gdwg::strongly_connected_components(csr);
+		CHECK(scc.count() == 0);
+		CHECK(scc.condensation().empty());
+	}
+
+	SECTION("long paths don't overflow the stack") {
+		auto const csr = gdwg::freeze(make_chain(50000, true));
+		auto const scc = gdwg::strongly_connected_components(csr);
+		CHECK(scc.count() == 1);
+
+		auto const open = gdwg::freeze(make_chain(50000, false));
+		auto const chain = gdwg::strongly_connected_components(open);
+		CHECK(chain.count() == 50000);
+		CHECK(chain.component(0) < chain.component(49999));
+	}
+
+	SECTION("matches mutual reachability") {
+		auto const csr = gdwg::freeze(make_random_graph(200, 300, false));
+		auto const scc = gdwg::strongly_connected_components(csr);
+		auto reach = std::vector<std::vector<std::uint32_t>>();
+		for (auto u = 0; u < 200; ++u) {
+			auto const tree = gdwg::bfs(csr, u, 1);
+			reach.emplace_back(tree.distances().begin(), tree.distances().end());
+		}
+		auto const reaches = [&reach](int u, int v) {
+			return reach[static_cast<std::size_t>(u)][static_cast<std::size_t>(v)]
+			       != gdwg::bfs_tree<int, int>::unreachable;
+		};
+		for (auto u = 0; u < 200; ++u) {
+			for (auto v = 0; v < 200; ++v) {
+				CHECK((scc.component(u) == scc.component(v)) == (reaches(u, v) and reaches(v, u)));
+			}
+		}
+		for (auto const& e : csr) {
+			CHECK(scc.component(std::get<0>(e)) <= scc.component(std::get<1>(e)));
+		}
+	}
+}
+
+TEST_CASE("topological_sort") {
+	SECTION("acyclic") {
+		auto const g = make_random_graph(500, 2000, true);
+		auto const csr = gdwg::freeze(g);
+		auto const result = gdwg::topological_sort(csr);
+		REQUIRE(result.acyclic());
+		REQUIRE(result.order.size() == 500);
+		auto position = std::vector<std::size_t>(500);
+		for (auto i = std::size_t{0}; i < result.order.size(); ++i) {
+			position[static_cast<std::size_t>(result.order[i])] = i;
+		}
+		for (auto const& e : g) {
+			CHECK(position[static_cast<std::size_t>(std::get<0>(e))]
+			      < position[static_cast<std::size_t>(std::get<1>(e))]);
+		}
+	}
+
+	SECTION("reports a cycle") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("c", "d", 1);
+		g.insert_edge("d", "b", 1);
+		g.insert_edge("d", "e", 1);
+		auto const result = gdwg::topological_sort(gdwg::freeze(g));
+		CHECK_FALSE(result.acyclic());
+		CHECK(result.order.empty());
+		CHECK(result.cycle == std::vector<std::string>{"b", "c", "d"});
+	}
+
+	SECTION("a self loop is a cycle") {
+		auto g = gdwg::graph<std::string, int>{"a", "b"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "b", 1);
+		auto const result = gdwg::topological_sort(gdwg::freeze(g));
+		CHECK(result.cycle == std::vector<std::string>{"b"});
+	}
+
+	SECTION("every reported cycle is real") {
+		auto const g = make_random_graph(300, 400, false);
+		auto const result = gdwg::topological_sort(gdwg::freeze(g));
+		REQUIRE_FALSE(result.acyclic());
+		for (auto i = std::size_t{0}; i < result.cycle.size(); ++i) {
+			CHECK(g.is_connected(result.cycle[i], result.cycle[(i + 1) % result.cycle.size()]));
+		}
+	}
+
+	SECTION("long chain") {
+		auto const result = gdwg::topological_sort(gdwg::freeze(make_chain(50000, false)));
+		REQUIRE(result.order.size() == 50000);
+		CHECK(result.order.front() == 0);
+		CHECK(result.order.back() == 49999);
+	}
+}
@@ -0,0 +1,180 @@
+#include "gdwg/concurrent_graph.hpp"
+
+#include "gdwg/graph.hpp"
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("concurrent_graph on one thread") {
+	auto g = gdwg::concurrent_graph<std::string, int>(4);
+	CHECK(g.empty());
+	CHECK(g.insert_node("a"));
+	CHECK(g.insert_node("b"));
+	CHECK(g.insert_node("c"));
+	CHECK_FALSE(g.insert_node("a"));
+	CHECK(g.insert_edge("a", "b", 2));
+	CHECK(g.insert_edge("a", "b", 1));
+	CHECK(g.insert_edge("c", "c", 1));
+	CHECK(g.insert_edge("c", "a", 1));
+	CHECK_FALSE(g.insert_edge("a", "b", 1));
+
+	CHECK(g.nodes() == std::vector<std::string>{"a", "b", "c"});
+	CHECK(g.weights("a", "b") == std::vector<int>{1, 2});
+	CHECK(g.connections("a") == std::vector<std::string>{"b", "b"});
+	CHECK(g.connections_to("a") == std::vector<std::string>{"c"});
+	CHECK(g.is_connected("c", "c"));
+	CHECK_FALSE(g.is_connected("b", "a"));
+
+	CHECK(g.erase_edge("a", "b", 2));
+	CHECK_FALSE(g.erase_edge("a", "b", 2));
+	CHECK(g.erase_node("c"));
+	CHECK_FALSE(g.erase_node("c"));
+	CHECK(g.connections_to("a").empty());
+
+	auto expected = gdwg::graph<std::string, int>{"a", "b"};
+	expected.insert_edge("a", "b", 1);
+	CHECK(g.to_graph() == expected);
+
+	CHECK_THROWS_MATCHES(g.insert_edge("a", "z", 1),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::concurrent_graph<N, E>::"
+	                                              "insert_edge when either src or dst node does not "
+	                                              "exist"));
+	CHECK_THROWS_AS(g.erase_edge("z", "a", 1), std::runtime_error);
+	CHECK_THROWS_AS(g.is_connected("a", "z"), std::runtime_error);
+	CHECK_THROWS_AS(g.weights("z", "a"), std::runtime_error);
+	CHECK_THROWS_AS(g.connections("z"), std::runtime_error);
+	CHECK_THROWS_AS(g.connections_to("z"), std::runtime_error);
+
+	g.clear();
+	CHECK(g.empty());
+}
+
+// Writers each own the edges out of a disjoint range of nodes, so the final graph doesn't depend
+// on how their changes interleave. Readers check that every answer they see is well formed.
+TEST_CASE("concurrent_graph stress") {
+	constexpr auto nodes = 64;
+	constexpr auto writers = 4;
+	constexpr auto readers = 4;
+	constexpr auto changes = 2000;
+
+	auto g = gdwg::concurrent_graph<int, int>(8);
+	for (auto i = 0; i < nodes; ++i) {
+		g.insert_node(i);
+	}
+	auto expected = std::vector<gdwg::graph<int, int>>(writers);
+	auto done = std::atomic<int>{0};
+	auto malformed = std::atomic<int>{0};
+	auto reads = std::atomic<long>{0};
+	{
+		auto threads = std::vector<std::jthread>();
+		for (auto w = 0; w < writers; ++w) {
+			threads.emplace_back([&, w] {
+				auto& mine = expected[static_cast<std::size_t>(w)];
+				for (auto i = 0; i < nodes; ++i) {
+					mine.insert_node(i);
+				}
+				auto rng = std::mt19937(static_cast<unsigned>(w));
+				auto src = std::uniform_int_distribution<int>(w * nodes / writers,
+				                                              (w + 1) * nodes / writers - 1);
+				auto dst = std::uniform_int_distribution<int>(0, nodes - 1);
+				auto weight = std::uniform_int_distribution<int>(0, 3);
+				for (auto i = 0; i < changes; ++i) {
+					auto const a = src(rng);
+					auto const b = dst(rng);
+					auto const c = weight(rng);
+					if (i % 3 == 0) {
+						g.erase_edge(a, b, c);
+						mine.erase_edge(a, b, c);
+					}
+					else {
+						g.insert_edge(a, b, c);
+						mine.insert_edge(a, b, c);
+					}
+				}
+				++done;
+			});
+		}
+		for (auto r = 0; r < readers; ++r) {
+			threads.emplace_back([&, r] {
+				auto rng = std::mt19937(static_cast<unsigned>(100 + r));
+				auto node = std::uniform_int_distribution<int>(0, nodes - 1);
+				while (done.load() < writers) {
+					auto const a = node(rng);
+					auto const b = node(rng);
+					auto const out = g.connections(a);
+					auto const weights = g.weights(a, b);
+					auto const connected = g.is_connected(a, b);
+					if (not std::is_sorted(out.begin(), out.end())
+					    or not std::is_sorted(weights.begin(), weights.end())
+					    or std::adjacent_find(weights.begin(), weights.end()) != weights.end()
+					    or weights.size() > 4 or not g.is_node(a))
+					{
+						++malformed;
+					}
+					static_cast<void>(connected);
+					++reads;
+				}
+			});
+		}
+	}
+
+	CHECK(malformed == 0);
+	CHECK(reads > 0);
+	auto merged = gdwg::graph<int, int>();
+	for (auto i = 0; i < nodes; ++i) {
+		merged.insert_node(i);
+	}
+	for (auto const& mine : expected) {
+		for (auto const& e : mine) {
+			merged.insert_edge(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+		}
+	}
+	CHECK(g.to_graph() == merged);
+	for (auto i = 0; i < nodes; ++i) {
+		CHECK(g.connections_to(i) == merged.connections_to(i));
+	}
+}
+
+TEST_CASE("concurrent_graph erase_node while reading") {
+	auto g = gdwg::concurrent_graph<int, int>(8);
+	for (auto i = 0; i < 200; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 200; ++i) {
+		g.insert_edge(i, (i + 1) % 200, 0);
+		g.insert_edge(i, (i + 7) % 200, 1);
+	}
+	auto stop = std::atomic<bool>{false};
+	{
+		auto reader = std::jthread([&] {
+			auto i = 0;
+			while (not stop.load()) {
+				try {
+					static_cast<void>(g.connections_to(i));
+				} catch (std::runtime_error const&) {
+					// i has already been erased.
+				}
+				i = (i + 1) % 200;
+			}
+		});
+		for (auto i = 0; i < 200; i += 2) {
+			CHECK(g.erase_node(i));
+		}
+		stop = true;
+	}
+	CHECK(g.nodes().size() == 100);
+	for (auto i = 1; i < 200; i += 2) {
+		for (auto const n : g.connections(i)) {
+			CHECK(n % 2 == 1);
+		}
+		for (auto const n : g.connections_to(i)) {
+			CHECK(n % 2 == 1);
+		}
+	}
+}
@@ -0,0 +1,121 @@
+#include "counting_allocator.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Every replaceable form of operator new and delete is defined here, so that whichever form
+// allocated a block, the matching form frees it. They live in their own translation unit so the
+// compiler never sees an allocation and its release inlined together.
+namespace {
+	auto count = std::atomic<std::size_t>{0};
+
+	auto allocate(std::size_t size) noexcept -> void* {
+		count.fetch_add(1, std::memory_order_relaxed);
+		return std::malloc(size == 0 ? 1 : size);
+	}
+
+	// aligned_alloc needs a size that is a multiple of the alignment.
+	auto allocate(std::size_t size, std::align_val_t alignment) noexcept -> void* {
+		count.fetch_add(1, std::memory_order_relaxed);
+		auto const align = static_cast<std::size_t>(alignment);
+		auto const rounded = size == 0 ? align : (size + align - 1) / align * align;
+		return std::aligned_alloc(align, rounded);
+	}
+
+	auto checked(void* p) -> void* {
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+} // namespace
+
+namespace gdwg::test {
+	auto allocations() noexcept -> std::size_t {
+		return count.load(std::memory_order_relaxed);
+	}
+} // namespace gdwg::test
+
+auto operator new(std::size_t size) -> void* {
+	return checked(allocate(size));
+}
+
+auto operator new[](std::size_t size) -> void* {
+	return checked(allocate(size));
+}
+
+auto operator new(std::size_t size, std::nothrow_t const&) noexcept -> void* {
+	return allocate(size);
+}
+
+auto operator new[](std::size_t size, std::nothrow_t const&) noexcept -> void* {
+	return allocate(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void* {
+	return checked(allocate(size, alignment));
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void* {
+	return checked(allocate(size, alignment));
+}
+
+auto operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept
+   -> void* {
+	return allocate(size, alignment);
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment, std::nothrow_t const&) noexcept
+   -> void* {
+	return allocate(size, alignment);
+}
+
+auto operator delete(void* p) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::size_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p, std::size_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::nothrow_t const&) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p, std::nothrow_t const&) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::align_val_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p, std::align_val_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::size_t, std::align_val_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p, std::size_t, std::align_val_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept -> void {
+	std::free(p);
+}
@@ -0,0 +1,15 @@
+#ifndef GDWG_TEST_COUNTING_ALLOCATOR_HPP
+#define GDWG_TEST_COUNTING_ALLOCATOR_HPP
+
+#include <cstddef>
+
+namespace gdwg::test {
+
+	// The number of calls to any form of global operator new so far. Linking
+	// counting_allocator.cpp replaces every global operator new and delete with ones that count
+	// and allocate with malloc.
+	auto allocations() noexcept -> std::size_t;
+
+} // namespace gdwg::test
+
+#endif // GDWG_TEST_COUNTING_ALLOCATOR_HPP
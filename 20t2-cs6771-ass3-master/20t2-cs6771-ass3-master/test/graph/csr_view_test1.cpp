@@ -0,0 +1,100 @@
+#include "gdwg/csr_view.hpp"
+
+#include "gdwg/graph.hpp"
+#include <catch2/catch.hpp>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+	auto make_graph() -> gdwg::graph<std::string, int> {
+		using graph = gdwg::graph<std::string, int>;
+		auto const v = std::vector<graph::value_type>{
+		   {"b", "a", 3},
+		   {"a", "c", 2},
+		   {"a", "b", 7},
+		   {"a", "b", 1},
+		   {"c", "a", 4},
+		   {"c", "c", 5},
+		};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node("d");
+		return g;
+	}
+} // namespace
+
+TEST_CASE("freeze builds both directions") {
+	auto const g = make_graph();
+	auto const csr = gdwg::freeze(g);
+	CHECK(csr.node_count() == 4);
+	CHECK(csr.edge_count() == 6);
+	CHECK(csr.node(csr.id("c")) == "c");
+	CHECK_THROWS_AS(csr.id("e"), std::runtime_error);
+
+	auto const& out = csr.forward();
+	CHECK(out.offsets == std::vector<std::size_t>{0, 3, 4, 6, 6});
+	CHECK(out.neighbours == std::vector<std::uint32_t>{1, 1, 2, 0, 0, 2});
+	CHECK(out.weights == std::vector<int>{1, 7, 2, 3, 4, 5});
+
+	auto const& in = csr.reverse();
+	CHECK(in.offsets == std::vector<std::size_t>{0, 2, 4, 6, 6});
+	CHECK(in.neighbours == std::vector<std::uint32_t>{1, 2, 0, 0, 0, 2});
+	CHECK(in.weights == std::vector<int>{3, 4, 1, 7, 2, 5});
+	CHECK(in.degree(csr.id("d")) == 0);
+}
+
+TEST_CASE("csr_view answers the same queries as graph") {
+	auto const g = make_graph();
+	auto const csr = gdwg::freeze(g);
+	for (auto const& n : g.nodes()) {
+		CHECK(csr.is_node(n));
+		CHECK(csr.connections(n) == g.connections(n));
+		CHECK(csr.connections_to(n) == g.connections_to(n));
+		for (auto const& m : g.nodes()) {
+			CHECK(csr.is_connected(n, m) == g.is_connected(n, m));
+			CHECK(csr.weights(n, m) == g.weights(n, m));
+		}
+	}
+	CHECK_FALSE(csr.is_node("e"));
+	CHECK_THROWS_AS(csr.connections("e"), std::runtime_error);
+}
+
+TEST_CASE("csr_view iterator") {
+	auto const g = make_graph();
+	auto const csr = gdwg::freeze(g);
+
+	SECTION("same sequence as graph::iterator") {
+		auto csr_it = csr.begin();
+		for (auto g_it = g.begin(); g_it != g.end(); ++g_it, ++csr_it) {
+			REQUIRE(csr_it != csr.end());
+			CHECK((*csr_it) == (*g_it));
+		}
+		CHECK(csr_it == csr.end());
+	}
+
+	SECTION("decrement") {
+		auto it = csr.end();
+		--it;
+		CHECK((*it) == std::tuple<std::string, std::string, int>{"c", "c", 5});
+		it--;
+		--it;
+		CHECK((*it) == std::tuple<std::string, std::string, int>{"b", "a", 3});
+		--it;
+		CHECK((*it) == std::tuple<std::string, std::string, int>{"a", "c", 2});
+	}
+
+	SECTION("find") {
+		auto const it = csr.find("a", "b", 7);
+		REQUIRE(it != csr.end());
+		CHECK((*it) == std::tuple<std::string, std::string, int>{"a", "b", 7});
+		CHECK(csr.find("a", "b", 2) == csr.end());
+		CHECK(csr.find("a", "e", 2) == csr.end());
+	}
+
+	SECTION("empty graph") {
+		auto const empty = gdwg::freeze(gdwg::graph<int, int>{1, 2});
+		CHECK(empty.begin() == empty.end());
+	}
+}
@@ -0,0 +1,150 @@
+#include "gdwg/edge_list.hpp"
+
+#include "gdwg/graph.hpp"
+#include "gdwg/slab_resource.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+	// Random "src dst weight" lines, with some repeats, comments and blank lines, and the graph
+	// they describe.
+	auto random_edge_list(int lines) -> std::pair<std::string, gdwg::graph<std::string, int>> {
+		auto rng = std::mt19937(6771);
+		auto node = std::uniform_int_distribution<int>(0, 999);
+		auto weight = std::uniform_int_distribution<int>(-5, 5);
+		auto kind = std::uniform_int_distribution<int>(0, 19);
+		auto text = std::string("# a random graph\n");
+		auto g = gdwg::graph<std::string, int>();
+		for (auto i = 0; i < lines; ++i) {
+			switch (kind(rng)) {
+			case 0: text += "\n"; break;
+			case 1: text += "# comment\n"; break;
+			default:
+				auto const src = "n" + std::to_string(node(rng));
+				auto const dst = "n" + std::to_string(node(rng));
+				auto const w = weight(rng);
+				text += src + "\t" + dst + "  " + std::to_string(w) + "\n";
+				g.insert_node(src);
+				g.insert_node(dst);
+				g.insert_edge(src, dst, w);
+			}
+		}
+		return {text, g};
+	}
+
+	struct upper_parser {
+		static auto parse(std::string_view field) -> std::optional<std::string> {
+			auto result = std::string(field);
+			for (auto& c : result) {
+				c = static_cast<char>(c - 'a' + 'A');
+			}
+			return result;
+		}
+	};
+} // namespace
+
+TEST_CASE("parse_edge_list reads whitespace-separated lists") {
+	auto const text = std::string_view("# FromNodeId\tToNodeId\n"
+	                                   "1\t2\n"
+	                                   "\n"
+	                                   "  2   3  \n"
+	                                   "3 1\r\n"
+	                                   "1 2\n"
+	                                   "# trailing comment");
+	auto const g = gdwg::parse_edge_list<int, int>(text);
+	CHECK(g.nodes() == std::vector<int>{1, 2, 3});
+	CHECK(g.weights(1, 2) == std::vector<int>{0});
+	CHECK(g.is_connected(2, 3));
+	CHECK(g.is_connected(3, 1));
+	CHECK(not g.is_connected(2, 1));
+
+	auto const weighted = gdwg::parse_edge_list<std::string, double>("a b 1.5\nb a -2e3\na a 0\n");
+	CHECK(weighted.weights("a", "b") == std::vector<double>{1.5});
+	CHECK(weighted.weights("b", "a") == std::vector<double>{-2000});
+	CHECK(weighted.is_connected("a", "a"));
+	CHECK(gdwg::parse_edge_list<int, int>("").empty());
+}
+
+TEST_CASE("parse_edge_list reads CSV") {
+	auto options = gdwg::edge_list_options();
+	options.delimiter = ',';
+	options.header = true;
+	auto const text = std::string_view("src,dst,weight\n"
+	                                   "alice, bob ,3\n"
+	                                   "bob,carol, 4\r\n"
+	                                   "carol,alice,5");
+	auto const g = gdwg::parse_edge_list<std::string, int>(text, options);
+	CHECK(g.nodes() == std::vector<std::string>{"alice", "bob", "carol"});
+	CHECK(g.weights("alice", "bob") == std::vector<int>{3});
+	CHECK(g.weights("carol", "alice") == std::vector<int>{5});
+
+	// Equal values written differently are the same node.
+	CHECK(gdwg::parse_edge_list<int, int>("007,7,1\n", options).empty());
+	auto const numbers = gdwg::parse_edge_list<int, int>("src,dst\n007,7,1\n", options);
+	CHECK(numbers.nodes() == std::vector<int>{7});
+	CHECK(numbers.is_connected(7, 7));
+}
+
+TEST_CASE("parse_edge_list takes custom parsers and a memory resource") {
+	auto slab = gdwg::slab_resource();
+	auto const g =
+	   gdwg::parse_edge_list<std::string, int>("a b 1\nb c 2\n", {}, upper_parser{}, {}, &slab);
+	CHECK(g.resource() == &slab);
+	CHECK(g.nodes() == std::vector<std::string>{"A", "B", "C"});
+	CHECK(g.is_connected("B", "C"));
+}
+
+TEST_CASE("parse_edge_list reports the first malformed line") {
+	auto const check_line = [](std::string_view text, int line) {
+		CHECK_THROWS_WITH((gdwg::parse_edge_list<int, int>(text)),
+		                  "Cannot call gdwg::parse_edge_list on malformed line "
+		                     + std::to_string(line));
+	};
+	check_line("1 2 3\n1\n", 2);
+	check_line("1 2 3 4\n", 1);
+	check_line("# c\n\n1 x 3\n", 3);
+	check_line("1 2 3\n1 2 3.5\n", 2);
+	check_line("1 2 3\n99999999999 2 3\n", 2);
+
+	auto options = gdwg::edge_list_options();
+	options.delimiter = ',';
+	CHECK_THROWS_WITH((gdwg::parse_edge_list<int, int>("1,,2\n", options)),
+	                  "Cannot call gdwg::parse_edge_list on malformed line 1");
+
+	SECTION("across blocks parsed on different threads") {
+		auto text = std::string();
+		for (auto i = 0; i < 5000; ++i) {
+			text += std::to_string(i) + " " + std::to_string(i + 1) + " 1\n";
+		}
+		text += "bad line\n";
+		for (auto i = 0; i < 5000; ++i) {
+			text += "1 2 3\n";
+		}
+		options = gdwg::edge_list_options();
+		options.threads = 4;
+		CHECK_THROWS_WITH((gdwg::parse_edge_list<int, int>(text, options)),
+		                  "Cannot call gdwg::parse_edge_list on malformed line 5001");
+	}
+}
+
+TEST_CASE("parse_edge_list matches inserting edges one at a time") {
+	auto const [text, expected] = random_edge_list(20000);
+	for (auto const threads : {1U, 2U, 3U, 8U}) {
+		auto options = gdwg::edge_list_options();
+		options.threads = threads;
+		CHECK(gdwg::parse_edge_list<std::string, int>(text, options) == expected);
+	}
+
+	auto const path = std::filesystem::temp_directory_path() / "gdwg_edge_list_test1.txt";
+	std::ofstream(path) << text;
+	CHECK(gdwg::load_edge_list<std::string, int>(path) == expected);
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,152 @@
+#include "gdwg/export.hpp"
+
+#include "gdwg/graph.hpp"
+#include <catch2/catch.hpp>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+	auto make_graph() -> gdwg::graph<std::string, double> {
+		using graph = gdwg::graph<std::string, double>;
+		auto const v = std::vector<graph::value_type>{
+		   {"a", "b", 1.5},
+		   {"say \"hi\"", "a", 2},
+		   {"b", "x<y>&z", -3},
+		};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node("back\\slash\n");
+		return g;
+	}
+} // namespace
+
+TEST_CASE("operator<< is unchanged by the single pass") {
+	SECTION("against printing each node's edges by search") {
+		auto rng = std::mt19937(6771);
+		auto node = std::uniform_int_distribution<int>(0, 299);
+		auto g = gdwg::graph<int, int>();
+		for (auto i = 0; i < 300; ++i) {
+			g.insert_node(i * 7);
+		}
+		for (auto i = 0; i < 6000; ++i) {
+			g.insert_edge(node(rng) * 7, node(rng) * 7, node(rng));
+		}
+
+		auto expected = std::ostringstream();
+		for (auto const& x : g.nodes()) {
+			expected << x << " (\n";
+			for (auto const& e : g) {
+				if (std::get<0>(e) == x) {
+					expected << "  " << std::get<1>(e) << " | " << std::get<2>(e) << "\n";
+				}
+			}
+			expected << ")\n";
+		}
+		auto actual = std::ostringstream();
+		actual << g;
+		CHECK(actual.str().size() > std::size_t{1} << 16U);
+		CHECK(actual.str() == expected.str());
+	}
+
+	SECTION("the stream's formatting is used") {
+		auto g = gdwg::graph<int, double>{255};
+		g.insert_edge(255, 255, 1.0 / 3);
+		auto out = std::ostringstream();
+		out << std::hex << std::setprecision(3) << g << 255;
+		CHECK(out.str() == "ff (\n  ff | 0.333\n)\nff");
+	}
+
+	SECTION("a width applies to the first node and not to what follows") {
+		auto small = gdwg::graph<int, int>{1};
+		auto out = std::ostringstream();
+		out << std::setw(4) << small << 7;
+		CHECK(out.str() == "   1 (\n)\n7");
+
+		auto large = gdwg::graph<int, int>();
+		for (auto i = 0; i < 1000; ++i) {
+			large.insert_node(i);
+		}
+		auto expected = std::ostringstream();
+		expected << large;
+		auto padded = std::ostringstream();
+		padded << std::setw(4) << large << 7;
+		CHECK(padded.str() == "   " + expected.str() + "7");
+		CHECK(padded.width() == 0);
+	}
+
+	SECTION("output after the graph keeps its order") {
+		auto const g = gdwg::graph<int, int>{1};
+		auto out = std::ostringstream();
+		out << "before\n" << g << "after\n";
+		CHECK(out.str() == "before\n1 (\n)\nafter\n");
+	}
+}
+
+TEST_CASE("write_dot") {
+	auto out = std::ostringstream();
+	gdwg::write_dot(out, make_graph());
+	CHECK(out.str() == R"(digraph {
+  "a";
+  "b";
+  "back\\slash\n";
+  "say \"hi\"";
+  "x<y>&z";
+  "a" -> "b" [label="1.5"];
+  "b" -> "x<y>&z" [label="-3"];
+  "say \"hi\"" -> "a" [label="2"];
+}
+)");
+
+	auto empty = std::ostringstream();
+	gdwg::write_dot(empty, gdwg::graph<int, int>());
+	CHECK(empty.str() == "digraph {\n}\n");
+
+	auto large = gdwg::graph<int, int>();
+	auto expected = std::string("digraph {\n");
+	for (auto i = 0; i < 3000; ++i) {
+		large.insert_node(i);
+		expected += "  \"" + std::to_string(i) + "\";\n";
+	}
+	auto buffered = std::ostringstream();
+	gdwg::write_dot(buffered, large);
+	CHECK(buffered.str() == expected + "}\n");
+}
+
+TEST_CASE("write_graphml") {
+	auto out = std::ostringstream();
+	gdwg::write_graphml(out, make_graph());
+	CHECK(out.str() == R"(<?xml version="1.0" encoding="UTF-8"?>
+<graphml xmlns="http://graphml.graphdrawing.org/xmlns">
+  <key id="name" for="node" attr.name="name" attr.type="string"/>
+  <key id="weight" for="edge" attr.name="weight" attr.type="double"/>
+  <graph edgedefault="directed">
+    <node id="n0"><data key="name">a</data></node>
+    <node id="n1"><data key="name">b</data></node>
+    <node id="n2"><data key="name">back\slash
+</data></node>
+    <node id="n3"><data key="name">say &quot;hi&quot;</data></node>
+    <node id="n4"><data key="name">x&lt;y&gt;&amp;z</data></node>
+    <edge source="n0" target="n1"><data key="weight">1.5</data></edge>
+    <edge source="n1" target="n4"><data key="weight">-3</data></edge>
+    <edge source="n3" target="n0"><data key="weight">2</data></edge>
+  </graph>
+</graphml>
+)");
+
+	SECTION("integer types and a hex stream") {
+		auto g = gdwg::graph<int, bool>{10, 11};
+		g.insert_edge(11, 10, true);
+		auto hex = std::ostringstream();
+		hex << std::hex;
+		gdwg::write_graphml(hex, g);
+		auto const text = hex.str();
+		CHECK(text.find(R"(attr.name="name" attr.type="long")") != std::string::npos);
+		CHECK(text.find(R"(attr.name="weight" attr.type="boolean")") != std::string::npos);
+		CHECK(text.find(R"(<node id="n1"><data key="name">b</data></node>)") != std::string::npos);
+		CHECK(text.find(R"(<edge source="n1" target="n0"><data key="weight">1</data></edge>)")
+		      != std::string::npos);
+	}
+}
@@ -0,0 +1,191 @@
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+	// Counts its equality comparisons.
+	struct counted {
+		static inline auto equality_calls = 0;
+		int value;
+
+		auto operator==(counted const& other) const -> bool {
+			++equality_calls;
+			return value == other.value;
+		}
+		auto operator<=>(counted const& other) const = default;
+	};
+
+	// Ordered but without a std::hash.
+	struct unhashed {
+		int value;
+		auto operator<=>(unhashed const&) const = default;
+	};
+} // namespace
+
+template<>
+struct std::hash<counted> {
+	auto operator()(counted const& x) const noexcept -> std::size_t {
+		return std::hash<int>()(x.value);
+	}
+};
+
+namespace {
+	// A graph with the same nodes and edges as g, built from scratch.
+	template<typename N, typename E>
+	auto rebuild(gdwg::graph<N, E> const& g) -> gdwg::graph<N, E> {
+		using graph = gdwg::graph<N, E>;
+		auto edges = std::vector<typename graph::value_type>();
+		for (auto const& e : g) {
+			edges.push_back({std::get<0>(e), std::get<1>(e), std::get<2>(e)});
+		}
+		auto result = graph(edges.rbegin(), edges.rend());
+		auto const nodes = g.nodes();
+		result.insert_nodes(nodes.rbegin(), nodes.rend());
+		return result;
+	}
+} // namespace
+
+TEST_CASE("Equal graphs have equal fingerprints however they were built") {
+	using graph = gdwg::graph<std::string, int>;
+	auto const v = std::vector<graph::value_type>{{"a", "b", 1}, {"b", "a", 1}, {"a", "a", 2}};
+	auto a = graph(v.begin(), v.end());
+	a.insert_node("c");
+
+	auto b = graph{"c", "b"};
+	b.insert_node("a");
+	b.insert_edge("a", "a", 2);
+	b.insert_edge("b", "a", 1);
+	b.insert_edge("a", "b", 1);
+	CHECK(a.fingerprint() == b.fingerprint());
+	CHECK(rebuild(a).fingerprint() == a.fingerprint());
+	CHECK(graph(a).fingerprint() == a.fingerprint());
+
+	SECTION("and different graphs differ") {
+		CHECK(graph().fingerprint() == 0);
+		CHECK(graph{"a"}.fingerprint() != graph{"b"}.fingerprint());
+		b.erase_edge("a", "b", 1);
+		b.insert_edge("a", "b", 3);
+		CHECK(a.fingerprint() != b.fingerprint());
+		b.erase_edge("a", "b", 3);
+		b.erase_edge("b", "a", 1);
+		auto c = b;
+		b.insert_edge("a", "b", 1);
+		c.insert_edge("b", "a", 1);
+		CHECK(b.fingerprint() != c.fingerprint());
+	}
+
+	SECTION("and undoing a change restores it") {
+		auto const before = a.fingerprint();
+		a.insert_node("d");
+		a.insert_edge("d", "a", 5);
+		CHECK(a.fingerprint() != before);
+		a.erase_node("d");
+		CHECK(a.fingerprint() == before);
+		a.replace_node("c", "e");
+		a.replace_node("e", "c");
+		CHECK(a.fingerprint() == before);
+		a.clear();
+		CHECK(a.fingerprint() == 0);
+	}
+
+	SECTION("and moves and assignments carry it") {
+		auto const expected = a.fingerprint();
+		auto moved = std::move(a);
+		CHECK(moved.fingerprint() == expected);
+		CHECK(a.fingerprint() == 0);
+		a = moved;
+		CHECK(a.fingerprint() == expected);
+		moved = graph{"z"};
+		CHECK(moved.fingerprint() == graph{"z"}.fingerprint());
+	}
+}
+
+TEST_CASE("The fingerprint follows every kind of change") {
+	auto rng = std::mt19937(6771);
+	auto node = std::uniform_int_distribution<int>(0, 29);
+	auto weight = std::uniform_int_distribution<int>(0, 3);
+	auto op = std::uniform_int_distribution<int>(0, 99);
+	auto g = gdwg::graph<int, int>();
+	for (auto i = 0; i < 3000; ++i) {
+		auto const a = node(rng);
+		auto const b = node(rng);
+		auto const kind = op(rng);
+		if (kind < 20) {
+			g.insert_node(a);
+		}
+		else if (kind < 55) {
+			if (g.is_node(a) and g.is_node(b)) {
+				g.insert_edge(a, b, weight(rng));
+			}
+		}
+		else if (kind < 70) {
+			if (g.is_node(a) and g.is_node(b)) {
+				g.erase_edge(a, b, weight(rng));
+			}
+		}
+		else if (kind < 80) {
+			g.erase_node(a);
+		}
+		else if (kind < 88) {
+			if (g.is_node(a)) {
+				g.replace_node(a, b);
+			}
+		}
+		else if (kind < 96) {
+			if (g.is_node(a) and g.is_node(b)) {
+				g.merge_replace_node(a, b);
+			}
+		}
+		else if (kind < 98) {
+			auto const batch = std::vector<int>{a, b, a + 30};
+			g.insert_nodes(batch.begin(), batch.end());
+		}
+		else if (g.begin() != g.end()) {
+			g.erase_edge(g.begin());
+		}
+		REQUIRE(g.fingerprint() == rebuild(g).fingerprint());
+	}
+	CHECK(rebuild(g) == g);
+}
+
+TEST_CASE("operator== rejects graphs with different fingerprints without comparing values") {
+	using graph = gdwg::graph<counted, int>;
+	auto edges = std::vector<graph::value_type>();
+	for (auto i = 0; i < 1000; ++i) {
+		edges.push_back({{i}, {(i * 7) % 1000}, i % 5});
+	}
+	auto const a = graph(edges.begin(), edges.end());
+	edges.back().weight += 1;
+	auto b = graph(edges.begin(), edges.end());
+
+	counted::equality_calls = 0;
+	CHECK(not(a == b));
+	CHECK(counted::equality_calls == 0);
+
+	b = a;
+	CHECK((a == b));
+	CHECK(counted::equality_calls > 0);
+}
+
+TEST_CASE("Values without std::hash still get a consistent fingerprint") {
+	using graph = gdwg::graph<unhashed, int>;
+	auto a = graph{{1}, {2}};
+	a.insert_edge({1}, {2}, 3);
+	auto b = graph{{2}, {1}};
+	b.insert_edge({1}, {2}, 3);
+	CHECK(a.fingerprint() == b.fingerprint());
+	CHECK((a == b));
+	b.replace_node({1}, {3});
+	CHECK(a.fingerprint() == b.fingerprint());
+	CHECK((a != b));
+	b.erase_node({3});
+	CHECK(a.fingerprint() != b.fingerprint());
+}
@@ -5,6 +5,8 @@
 #include <fmt/ostream.h>
 #include <functional>
 #include <iterator>
+#include <numeric>
+#include <random>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -114,6 +116,28 @@ TEST_CASE("Constructors") {
 		CHECK(g.weights(2, 3) == std::vector<int>{4});
 	}
 
+	SECTION("value_type constructor matches inserting one at a time") {
+		auto rng = std::mt19937(6771);
+		auto node = std::uniform_int_distribution<int>(0, 499);
+		auto weight = std::uniform_int_distribution<int>(0, 3);
+		auto values = std::vector<gdwg::graph<int, int>::value_type>();
+		auto expected = gdwg::graph<int, int>();
+		for (auto i = 0; i < 20000; ++i) {
+			auto const value = gdwg::graph<int, int>::value_type{node(rng), node(rng), weight(rng)};
+			values.push_back(value);
+			expected.insert_node(value.from);
+			expected.insert_node(value.to);
+			expected.insert_edge(value.from, value.to, value.weight);
+		}
+		auto const g = gdwg::graph<int, int>{values.begin(), values.end()};
+		CHECK(g == expected);
+		for (auto const n : expected.nodes()) {
+			CHECK(g.connections_to(n) == expected.connections_to(n));
+		}
+		auto const empty = std::vector<gdwg::graph<int, int>::value_type>();
+		CHECK(gdwg::graph<int, int>{empty.begin(), empty.end()}.empty());
+	}
+
 	SECTION("move constructor test") {
 		auto g = gdwg::graph<int, int>{1, 2, 3};
 		auto g_moved = gdwg::graph<int, int>(std::move(g));
@@ -139,6 +163,17 @@ TEST_CASE("Constructors") {
 		CHECK(g2.is_node(5));
 		CHECK_FALSE(g.is_node(5));
 	}
+
+	SECTION("Copy constructor does not share nodes with the original") {
+		auto g = gdwg::graph<std::string, int>{"a", "b"};
+		g.insert_edge("a", "b", 1);
+		auto const copy = gdwg::graph<std::string, int>(g);
+		g.replace_node("a", "c");
+		g.erase_node("b");
+		CHECK(copy.connections("a") == std::vector<std::string>{"b"});
+		CHECK(copy.connections_to("b") == std::vector<std::string>{"a"});
+		CHECK((*copy.begin()) == std::tuple<std::string, std::string, int>{"a", "b", 1});
+	}
 }
 
 TEST_CASE("Assignment") {
@@ -214,6 +249,87 @@ TEST_CASE("Modifiers") {
 	}
 }
 
+TEST_CASE("Batch modifiers") {
+	using value_type = gdwg::graph<std::string, int>::value_type;
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+	g.insert_edge("a", "b", 1);
+
+	SECTION("insert_nodes") {
+		auto const values = std::vector<std::string>{"d", "a", "e", "d"};
+		CHECK(g.insert_nodes(values.begin(), values.end())
+		      == std::vector<bool>{true, false, true, false});
+		CHECK(g.nodes() == std::vector<std::string>{"a", "b", "c", "d", "e"});
+	}
+
+	SECTION("insert_edges") {
+		auto const edges =
+		   std::vector<value_type>{{"c", "a", 2}, {"a", "b", 1}, {"a", "c", 3}, {"c", "a", 2}};
+		CHECK(g.insert_edges(edges.begin(), edges.end())
+		      == std::vector<bool>{true, false, true, false});
+		CHECK(g.connections("a") == std::vector<std::string>{"b", "c"});
+		CHECK(g.connections_to("a") == std::vector<std::string>{"c"});
+	}
+
+	SECTION("erase_edges") {
+		g.insert_edge("b", "c", 1);
+		auto const edges = std::vector<value_type>{{"b", "c", 1}, {"a", "c", 1}, {"b", "c", 1}};
+		CHECK(g.erase_edges(edges.begin(), edges.end()) == std::vector<bool>{true, false, false});
+		CHECK(g.connections_to("c").empty());
+		CHECK(g.connections("a") == std::vector<std::string>{"b"});
+	}
+
+	SECTION("a missing node leaves the graph unchanged") {
+		auto const copy = g;
+		auto const edges = std::vector<value_type>{{"b", "c", 1}, {"a", "z", 1}};
+		CHECK_THROWS_MATCHES(g.insert_edges(edges.begin(), edges.end()),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::insert_edges "
+		                                              "when either src or dst node does not exist"));
+		auto const erase = std::vector<value_type>{{"a", "b", 1}, {"z", "a", 1}};
+		CHECK_THROWS_MATCHES(g.erase_edges(erase.begin(), erase.end()),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::erase_edges on "
+		                                              "src or dst if they don't exist in the graph"));
+		CHECK(g == copy);
+	}
+
+	SECTION("matches inserting and erasing one at a time") {
+		auto rng = std::mt19937(6771);
+		auto node = std::uniform_int_distribution<int>(0, 99);
+		auto weight = std::uniform_int_distribution<int>(0, 3);
+		auto batch = gdwg::graph<int, int>();
+		auto expected = gdwg::graph<int, int>();
+		auto nodes = std::vector<int>(100);
+		std::iota(nodes.begin(), nodes.end(), 0);
+		batch.insert_nodes(nodes.begin(), nodes.end());
+		for (auto const n : nodes) {
+			expected.insert_node(n);
+		}
+		for (auto round = 0; round < 4; ++round) {
+			auto inserts = std::vector<gdwg::graph<int, int>::value_type>();
+			auto erases = std::vector<gdwg::graph<int, int>::value_type>();
+			for (auto i = 0; i < 500; ++i) {
+				inserts.push_back({node(rng), node(rng), weight(rng)});
+				erases.push_back({node(rng), node(rng), weight(rng)});
+			}
+			auto const inserted = batch.insert_edges(inserts.begin(), inserts.end());
+			for (auto i = std::size_t{0}; i < inserts.size(); ++i) {
+				auto const& e = inserts[i];
+				CHECK(inserted[i] == expected.insert_edge(e.from, e.to, e.weight));
+			}
+			auto const erased = batch.erase_edges(erases.begin(), erases.end());
+			for (auto i = std::size_t{0}; i < erases.size(); ++i) {
+				auto const& e = erases[i];
+				CHECK(erased[i] == expected.erase_edge(e.from, e.to, e.weight));
+			}
+			CHECK(batch == expected);
+		}
+		for (auto const n : nodes) {
+			CHECK(batch.connections_to(n) == expected.connections_to(n));
+		}
+	}
+}
+
 TEST_CASE("Extractor") {
 	SECTION("<<operator empty") {
 		auto const g = gdwg::graph<int, int>();
@@ -461,3 +577,110 @@ TEST_CASE("Exceptions") {
 		                                              "src doesn't exist in the graph"));
 	}
 }
+
+TEST_CASE("Neighbour lookups") {
+	auto g = gdwg::graph<int, int>{1, 2, 3, 4};
+	g.insert_edge(1, 1, 4);
+	g.insert_edge(2, 1, 3);
+	g.insert_edge(2, 3, 2);
+	g.insert_edge(2, 3, 1);
+	g.insert_edge(2, 4, 5);
+	g.insert_edge(3, 2, 6);
+
+	SECTION("connections only returns edges from src") {
+		CHECK(g.connections(1) == std::vector<int>{1});
+		CHECK(g.connections(2) == std::vector<int>{1, 3, 3, 4});
+		CHECK(std::empty(g.connections(4)));
+	}
+
+	SECTION("weights only returns edges from src to dst") {
+		CHECK(g.weights(2, 3) == std::vector<int>{1, 2});
+		CHECK(g.weights(3, 2) == std::vector<int>{6});
+		CHECK(std::empty(g.weights(1, 2)));
+	}
+
+	SECTION("is_connected") {
+		CHECK(g.is_connected(1, 1));
+		CHECK(g.is_connected(2, 4));
+		CHECK_FALSE(g.is_connected(4, 2));
+		CHECK_FALSE(g.is_connected(1, 2));
+	}
+
+	SECTION("find and erase_edge") {
+		CHECK(g.find(2, 3, 3) == g.end());
+		auto const it = g.find(2, 3, 2);
+		REQUIRE(it != g.end());
+		CHECK((*it) == std::tuple{2, 3, 2});
+		CHECK(g.erase_edge(2, 3, 1));
+		CHECK_FALSE(g.erase_edge(2, 3, 1));
+		CHECK(g.weights(2, 3) == std::vector<int>{2});
+	}
+}
+
+TEST_CASE("Incoming edges") {
+	auto g = gdwg::graph<int, int>{1, 2, 3, 4};
+	g.insert_edge(1, 3, 1);
+	g.insert_edge(2, 3, 2);
+	g.insert_edge(3, 3, 3);
+	g.insert_edge(3, 1, 4);
+	g.insert_edge(2, 4, 5);
+
+	SECTION("connections_to") {
+		CHECK(g.connections_to(3) == std::vector<int>{1, 2, 3});
+		CHECK(g.connections_to(1) == std::vector<int>{3});
+		CHECK(std::empty(g.connections_to(2)));
+		CHECK_THROWS_MATCHES(g.connections_to(5),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::connections_to "
+		                                              "if dst doesn't exist in the graph"));
+	}
+
+	SECTION("replace_node moves incoming edges and self loops") {
+		CHECK(g.replace_node(3, 7));
+		CHECK(g.connections_to(7) == std::vector<int>{1, 2, 7});
+		CHECK(g.connections(7) == std::vector<int>{1, 7});
+		CHECK(g.weights(7, 7) == std::vector<int>{3});
+		CHECK(g.connections_to(1) == std::vector<int>{7});
+	}
+
+	SECTION("merge_replace_node drops duplicate incoming edges") {
+		g.insert_edge(2, 1, 1);
+		g.merge_replace_node(3, 1);
+		CHECK(g.connections_to(1) == std::vector<int>{1, 1, 1, 2, 2});
+		CHECK(g.weights(1, 1) == std::vector<int>{1, 3, 4});
+		CHECK(g.weights(2, 1) == std::vector<int>{1, 2});
+		CHECK(g.connections(1) == std::vector<int>{1, 1, 1});
+	}
+
+	SECTION("merge_replace_node onto itself changes nothing") {
+		auto const before = g;
+		g.merge_replace_node(3, 3);
+		CHECK(g == before);
+	}
+
+	SECTION("erase_node removes incoming edges") {
+		CHECK(g.erase_node(3));
+		CHECK(std::empty(g.connections(1)));
+		CHECK(g.connections(2) == std::vector<int>{4});
+		CHECK(std::empty(g.connections_to(1)));
+		CHECK(g.connections_to(4) == std::vector<int>{2});
+	}
+
+	SECTION("erase_edge updates incoming edges") {
+		CHECK(g.erase_edge(2, 3, 2));
+		g.erase_edge(g.find(1, 3, 1));
+		CHECK(g.connections_to(3) == std::vector<int>{3});
+		g.erase_edge(g.begin(), g.end());
+		CHECK(std::empty(g.connections_to(3)));
+		CHECK(std::empty(g.connections_to(4)));
+	}
+
+	SECTION("copies and moves keep incoming edges") {
+		auto copy = g;
+		CHECK(copy.connections_to(3) == std::vector<int>{1, 2, 3});
+		auto moved = gdwg::graph<int, int>();
+		moved = std::move(copy);
+		CHECK(moved.connections_to(3) == std::vector<int>{1, 2, 3});
+		CHECK(moved == g);
+	}
+}
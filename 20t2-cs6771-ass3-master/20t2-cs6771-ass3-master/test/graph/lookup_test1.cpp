@@ -0,0 +1,100 @@
+#include "gdwg/graph.hpp"
+
+#include "counting_allocator.hpp"
+#include <catch2/catch.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+	using graph = gdwg::graph<std::string, int>;
+	using namespace std::string_view_literals;
+
+	// Longer than any small string buffer, so building a std::string from one allocates.
+	constexpr auto alpha = "alpha: a node name too long to be stored inline"sv;
+	constexpr auto beta = "beta: another node name too long to be stored inline"sv;
+	constexpr auto omega = "omega: a third node name too long to be stored inline"sv;
+
+	auto make_graph() -> graph {
+		auto g = graph{std::string(alpha), std::string(beta), std::string(omega)};
+		g.insert_edge(std::string(alpha), std::string(beta), 1);
+		g.insert_edge(std::string(alpha), std::string(beta), 2);
+		g.insert_edge(std::string(beta), std::string(omega), 3);
+		return g;
+	}
+} // namespace
+
+TEST_CASE("Lookups by std::string_view construct no nodes") {
+	auto const g = make_graph();
+	auto const before = gdwg::test::allocations();
+	auto total = 0;
+	CHECK(g.is_node(alpha));
+	CHECK(not g.is_node(alpha.substr(1)));
+	CHECK(g.is_connected(alpha, beta));
+	CHECK(not g.is_connected(beta, alpha));
+	CHECK(g.find(beta, omega, 3) != g.end());
+	CHECK(g.find(beta, omega, 4) == g.end());
+	for (auto const w : g.weights_view(alpha, beta)) {
+		total += w;
+	}
+	for (auto const& x : g.connections_view(beta)) {
+		total += static_cast<int>(x.size());
+	}
+	for (auto const& x : g.connections_to_view(beta)) {
+		total += static_cast<int>(x.size());
+	}
+	CHECK(gdwg::test::allocations() == before);
+	CHECK(total == 3 + static_cast<int>(omega.size() + 2 * alpha.size()));
+}
+
+TEST_CASE("Keys of different types can be mixed") {
+	auto g = make_graph();
+	auto const a = std::string(alpha);
+	CHECK(g.weights(a, beta) == std::vector<int>{1, 2});
+	CHECK(g.weights(beta.data(), omega) == std::vector<int>{3});
+	CHECK(g.connections(alpha) == std::vector<std::string>{std::string(beta), std::string(beta)});
+	CHECK(g.connections_to(omega) == std::vector<std::string>{std::string(beta)});
+
+	g.insert_node("x");
+	CHECK(g.insert_edge("x", alpha, 5));
+	CHECK(not g.insert_edge("x", a, 5));
+	CHECK(g.is_connected("x", a));
+	CHECK(g.erase_edge("x", alpha, 5));
+	CHECK(not g.erase_edge(std::string("x"), alpha, 5));
+	CHECK(g.erase_node("x"));
+	CHECK(not g.erase_node("x"));
+	CHECK(g.nodes() == std::vector<std::string>{a, std::string(beta), std::string(omega)});
+}
+
+TEST_CASE("Node replacement takes keys for existing nodes") {
+	auto g = make_graph();
+	CHECK(not g.replace_node(alpha, std::string(beta)));
+	CHECK(g.replace_node(alpha, "delta"));
+	CHECK(not g.is_node(alpha));
+	CHECK(g.weights("delta", beta) == std::vector<int>{1, 2});
+
+	g.merge_replace_node(beta, std::string(beta));
+	CHECK(g.connections(beta) == std::vector<std::string>{std::string(omega)});
+	g.merge_replace_node("delta", omega);
+	CHECK(g.nodes() == std::vector<std::string>{std::string(beta), std::string(omega)});
+	CHECK(g.weights(omega, beta) == std::vector<int>{1, 2});
+	CHECK(g.connections_to(omega) == std::vector<std::string>{std::string(beta)});
+}
+
+TEST_CASE("Keys for missing nodes throw as nodes do") {
+	auto g = make_graph();
+	CHECK_THROWS_WITH(g.insert_edge(alpha, "missing"sv, 1),
+	                  "Cannot call gdwg::graph<N, E>::insert_edge when either src or dst node does "
+	                  "not exist");
+	CHECK_THROWS_WITH(g.is_connected("missing"sv, alpha),
+	                  "Cannot call gdwg::graph<N, E>::is_connected if src or dst node don't exist "
+	                  "in the graph");
+	CHECK_THROWS_WITH(g.connections("missing"sv),
+	                  "Cannot call gdwg::graph<N, E>::connections if src doesn't exist in the "
+	                  "graph");
+	CHECK_THROWS_WITH(g.replace_node("missing"sv, "new"),
+	                  "Cannot call gdwg::graph<N, E>::replace_node on a node that doesn't exist");
+	CHECK_THROWS_WITH(g.merge_replace_node(alpha, "missing"sv),
+	                  "Cannot call gdwg::graph<N, E>::merge_replace_node on old or new data if they "
+	                  "don't exist in the graph");
+}
@@ -0,0 +1,147 @@
+#include "gdwg/pagerank.hpp"
+
+#include "gdwg/csr_view.hpp"
+#include "gdwg/graph.hpp"
+#include "random_graph.hpp"
+#include <catch2/catch.hpp>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto make_random_graph(int nodes, int edges) -> gdwg::graph<int, double> {
+		return gdwg::test::make_random_graph(nodes,
+		                                     edges,
+		                                     std::uniform_real_distribution<double>(0.5, 2.0));
+	}
+
+	// A direct power iteration over the graph's edges, for comparison.
+	auto reference_pagerank(gdwg::graph<int, double> const& g, double damping, int iterations)
+	   -> std::vector<double> {
+		auto const n = g.nodes().size();
+		auto out = std::vector<double>(n, 0.0);
+		for (auto const& e : g) {
+			out[static_cast<std::size_t>(std::get<0>(e))] += std::get<2>(e);
+		}
+		auto scores = std::vector<double>(n, 1.0 / static_cast<double>(n));
+		for (auto i = 0; i < iterations; ++i) {
+			auto dangling = 0.0;
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				if (out[u] == 0.0) {
+					dangling += scores[u];
+				}
+			}
+			auto const teleport = (damping * dangling + 1.0 - damping) / static_cast<double>(n);
+			auto next = std::vector<double>(n, teleport);
+			for (auto const& e : g) {
+				auto const u = static_cast<std::size_t>(std::get<0>(e));
+				next[static_cast<std::size_t>(std::get<1>(e))] +=
+				   damping * scores[u] * std::get<2>(e) / out[u];
+			}
+			scores = next;
+		}
+		return scores;
+	}
+} // namespace
+
+TEST_CASE("sparse_matrix") {
+	auto g = gdwg::graph<int, int>{0, 1, 2};
+	g.insert_edge(0, 1, 2);
+	g.insert_edge(0, 2, 6);
+	g.insert_edge(2, 0, 3);
+	auto const csr = gdwg::freeze(g);
+	auto const x = std::vector<double>{1, 10, 100};
+	auto y = std::vector<double>(3);
+
+	SECTION("incoming") {
+		auto const m = gdwg::sparse_matrix::incoming(csr);
+		CHECK(m.rows() == 3);
+		CHECK(m.nonzeros() == 3);
+		m.multiply(x, y, 2);
+		CHECK(y == std::vector<double>{300, 2, 6});
+	}
+
+	SECTION("outgoing") {
+		gdwg::sparse_matrix::outgoing(csr).multiply(x, y, 2);
+		CHECK(y == std::vector<double>{620, 0, 3});
+	}
+
+	SECTION("transition") {
+		auto const change = gdwg::sparse_matrix::transition(csr).multiply(x, y, 2);
+		CHECK(y == std::vector<double>{100, 0.25, 0.75});
+		CHECK(change == Approx(99 + 9.75 + 99.25));
+	}
+
+	SECTION("size mismatch") {
+		auto short_y = std::vector<double>(2);
+		CHECK_THROWS_AS(gdwg::sparse_matrix::incoming(csr).multiply(x, short_y, 1),
+		                std::runtime_error);
+	}
+}
+
+TEST_CASE("pagerank") {
+	SECTION("a cycle ranks every node equally") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("b", "c", 1);
+		g.insert_edge("c", "a", 1);
+		auto const result = gdwg::pagerank(gdwg::freeze(g));
+		CHECK(result.converged);
+		for (auto const s : result.scores) {
+			CHECK(s == Approx(1.0 / 3));
+		}
+	}
+
+	SECTION("heavier edges pass more rank") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+		g.insert_edge("a", "b", 9);
+		g.insert_edge("a", "c", 1);
+		g.insert_edge("b", "a", 1);
+		g.insert_edge("c", "a", 1);
+		auto const csr = gdwg::freeze(g);
+		auto const result = gdwg::pagerank(csr);
+		CHECK(result.scores[csr.id("b")] > 3 * result.scores[csr.id("c")]);
+	}
+
+	SECTION("matches a direct power iteration") {
+		auto const g = make_random_graph(300, 1200);
+		auto const expected = reference_pagerank(g, 0.85, 200);
+		auto options = gdwg::pagerank_options{};
+		options.tolerance = 1e-12;
+		options.max_iterations = 1000;
+		options.threads = 4;
+		auto const result = gdwg::pagerank(gdwg::freeze(g), options);
+		CHECK(result.converged);
+		CHECK(std::accumulate(result.scores.begin(), result.scores.end(), 0.0) == Approx(1.0));
+		for (auto i = std::size_t{0}; i < expected.size(); ++i) {
+			CHECK(result.scores[i] == Approx(expected[i]).margin(1e-9));
+		}
+	}
+
+	SECTION("max_iterations") {
+		auto options = gdwg::pagerank_options{};
+		options.max_iterations = 3;
+		options.tolerance = 0;
+		auto const result = gdwg::pagerank(gdwg::freeze(make_random_graph(50, 100)), options);
+		CHECK(result.iterations == 3);
+		CHECK_FALSE(result.converged);
+	}
+
+	SECTION("personalized") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 1);
+		g.insert_edge("c", "d", 1);
+		auto const csr = gdwg::freeze(g);
+		auto const result = gdwg::personalized_pagerank(csr, std::vector<std::string>{"a"});
+		CHECK(result.scores[csr.id("c")] == Approx(0.0));
+		CHECK(result.scores[csr.id("d")] == Approx(0.0));
+		CHECK(result.scores[csr.id("a")] > result.scores[csr.id("b")]);
+		CHECK(std::accumulate(result.scores.begin(), result.scores.end(), 0.0) == Approx(1.0));
+		CHECK_THROWS_MATCHES(gdwg::personalized_pagerank(csr, std::vector<std::string>{"z"}),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::personalized_pagerank if a "
+		                                              "seed doesn't exist in the graph"));
+	}
+}
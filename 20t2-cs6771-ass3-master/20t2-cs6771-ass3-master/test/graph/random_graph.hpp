@@ -0,0 +1,33 @@
+#ifndef GDWG_TEST_RANDOM_GRAPH_HPP
+#define GDWG_TEST_RANDOM_GRAPH_HPP
+
+#include "gdwg/graph.hpp"
+
+#include <random>
+#include <type_traits>
+
+namespace gdwg::test {
+
+	// The nodes 0 to nodes - 1 and `edges` draws of an edge between two uniformly chosen nodes,
+	// weighted by weight(rng). Repeated draws are dropped, so there can be fewer edges. The same
+	// arguments always give the same graph.
+	template<typename Weight>
+	auto make_random_graph(int nodes, int edges, Weight weight)
+	   -> graph<int, std::invoke_result_t<Weight&, std::mt19937&>> {
+		auto g = graph<int, std::invoke_result_t<Weight&, std::mt19937&>>();
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		auto rng = std::mt19937(6771);
+		auto node = std::uniform_int_distribution<int>(0, nodes - 1);
+		for (auto i = 0; i < edges; ++i) {
+			auto const src = node(rng);
+			auto const dst = node(rng);
+			g.insert_edge(src, dst, weight(rng));
+		}
+		return g;
+	}
+
+} // namespace gdwg::test
+
+#endif // GDWG_TEST_RANDOM_GRAPH_HPP
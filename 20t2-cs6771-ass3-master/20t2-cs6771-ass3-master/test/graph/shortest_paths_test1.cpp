@@ -0,0 +1,218 @@
+#include "gdwg/shortest_paths.hpp"
+
+#include "gdwg/csr_view.hpp"
+#include "gdwg/detail/dary_heap.hpp"
+#include "gdwg/graph.hpp"
+#include "random_graph.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	auto make_graph() -> gdwg::graph<std::string, int> {
+		using graph = gdwg::graph<std::string, int>;
+		auto const v = std::vector<graph::value_type>{
+		   {"a", "b", 4},
+		   {"a", "c", 1},
+		   {"c", "b", 2},
+		   {"b", "d", 1},
+		   {"c", "d", 5},
+		   {"d", "e", 3},
+		   {"e", "a", 1},
+		};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node("f");
+		return g;
+	}
+
+	auto make_random_graph(int nodes, int edges) -> gdwg::graph<int, double> {
+		return gdwg::test::make_random_graph(nodes,
+		                                     edges,
+		                                     std::uniform_real_distribution<double>(0.0, 10.0));
+	}
+} // namespace
+
+TEST_CASE("dary_heap") {
+	auto heap = gdwg::detail::dary_heap<int>();
+	auto rng = std::mt19937(1);
+	auto values = std::vector<int>(500);
+	std::generate(values.begin(), values.end(), [&rng] { return static_cast<int>(rng() % 100); });
+	for (auto v : values) {
+		heap.push(v);
+	}
+	std::sort(values.begin(), values.end());
+	auto popped = std::vector<int>();
+	while (not heap.empty()) {
+		popped.push_back(heap.top());
+		heap.pop();
+	}
+	CHECK(popped == values);
+}
+
+TEST_CASE("dijkstra") {
+	auto const csr = gdwg::freeze(make_graph());
+
+	SECTION("distances and paths") {
+		auto const tree = gdwg::dijkstra(csr, std::string("a"));
+		CHECK(tree.source() == "a");
+		CHECK(tree.distance("a") == 0);
+		CHECK(tree.distance("b") == 3);
+		CHECK(tree.distance("d") == 4);
+		CHECK(tree.distance("e") == 7);
+		CHECK(tree.path_to("e") == std::vector<std::string>{"a", "c", "b", "d", "e"});
+		CHECK(tree.path_to("a") == std::vector<std::string>{"a"});
+	}
+
+	SECTION("unreachable nodes") {
+		auto const tree = gdwg::dijkstra(csr, std::string("a"));
+		CHECK_FALSE(tree.reachable("f"));
+		CHECK(tree.distance("f") == decltype(tree)::unreachable);
+		CHECK(std::empty(tree.path_to("f")));
+	}
+
+	SECTION("early termination") {
+		auto const tree = gdwg::dijkstra(csr, std::string("a"), std::string("b"));
+		CHECK(tree.distance("b") == 3);
+		CHECK(tree.path_to("b") == std::vector<std::string>{"a", "c", "b"});
+	}
+
+	SECTION("errors") {
+		CHECK_THROWS_MATCHES(gdwg::dijkstra(csr, std::string("z")),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::dijkstra if source doesn't "
+		                                              "exist in the graph"));
+		auto negative = gdwg::graph<int, int>{1, 2};
+		negative.insert_edge(1, 2, -1);
+		CHECK_THROWS_MATCHES(gdwg::dijkstra(gdwg::freeze(negative), 1),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::dijkstra on a graph with "
+		                                              "negative edge weights"));
+	}
+}
+
+TEST_CASE("delta_stepping") {
+	SECTION("matches dijkstra on a small graph") {
+		auto const csr = gdwg::freeze(make_graph());
+		auto const tree = gdwg::delta_stepping(csr, std::string("a"), 2, 4);
+		CHECK(tree.distance("e") == 7);
+		CHECK(tree.path_to("e") == std::vector<std::string>{"a", "c", "b", "d", "e"});
+		CHECK_FALSE(tree.reachable("f"));
+	}
+
+	SECTION("matches dijkstra on a random graph") {
+		auto const csr = gdwg::freeze(make_random_graph(2000, 16000));
+		auto const expected = gdwg::dijkstra(csr, 0);
+		for (auto const delta : {0.5, 2.5, 100.0}) {
+			auto const actual = gdwg::delta_stepping(csr, 0, delta, 4);
+			REQUIRE(std::equal(expected.distances().begin(),
+			                   expected.distances().end(),
+			                   actual.distances().begin(),
+			                   actual.distances().end()));
+			for (auto v = 1; v < 2000; v += 37) {
+				auto const path = actual.path_to(v);
+				if (not path.empty()) {
+					auto length = 0.0;
+					for (auto i = std::size_t{1}; i < path.size(); ++i) {
+						auto const w = csr.weights(path[i - 1], path[i]);
+						length += *std::min_element(w.begin(), w.end());
+					}
+					CHECK(length == actual.distance(v));
+				}
+			}
+		}
+	}
+
+	SECTION("a delta far below the edge weights") {
+		auto const csr = gdwg::freeze(make_random_graph(500, 4000));
+		auto const expected = gdwg::dijkstra(csr, 0);
+		auto const actual = gdwg::delta_stepping(csr, 0, 1e-12, 4);
+		CHECK(std::equal(expected.distances().begin(),
+		                 expected.distances().end(),
+		                 actual.distances().begin(),
+		                 actual.distances().end()));
+	}
+
+	SECTION("zero-weight edges, cycles and self loops") {
+		using graph = gdwg::graph<std::string, int>;
+		auto const v = std::vector<graph::value_type>{
+		   {"s", "a", 1},
+		   {"a", "a", 0},
+		   {"a", "b", 0},
+		   {"b", "c", 0},
+		   {"c", "a", 0},
+		   {"c", "c", 0},
+		   {"s", "c", 1},
+		   {"c", "d", 2},
+		   {"d", "d", 0},
+		};
+		auto const csr = gdwg::freeze(graph(v.begin(), v.end()));
+		for (auto const delta : {1, 3}) {
+			auto const tree = gdwg::delta_stepping(csr, std::string("s"), delta, 2);
+			CHECK(tree.path_to("a") == std::vector<std::string>{"s", "a"});
+			CHECK(tree.path_to("b") == std::vector<std::string>{"s", "a", "b"});
+			CHECK(tree.path_to("c") == std::vector<std::string>{"s", "c"});
+			CHECK(tree.path_to("d") == std::vector<std::string>{"s", "c", "d"});
+		}
+
+		auto self_loop = gdwg::graph<std::string, int>{"s", "a"};
+		self_loop.insert_edge("s", "a", 1);
+		self_loop.insert_edge("a", "a", 0);
+		auto const loop_csr = gdwg::freeze(self_loop);
+		auto const tree = gdwg::delta_stepping(loop_csr, std::string("s"), 1, 1);
+		CHECK(tree.path_to("a") == std::vector<std::string>{"s", "a"});
+	}
+
+	SECTION("random graphs with many zero-weight edges") {
+		// Weights of 0 to 3, three sevenths of them 0.
+		auto weight = [w = std::uniform_int_distribution<int>(-3, 3)](std::mt19937& rng) mutable {
+			return std::max(w(rng), 0);
+		};
+		auto g = gdwg::test::make_random_graph(300, 1500, weight);
+		for (auto i = 0; i < 300; ++i) {
+			g.insert_edge(i, i, 0);
+		}
+		auto const csr = gdwg::freeze(g);
+		auto const expected = gdwg::dijkstra(csr, 0);
+		for (auto const delta : {1, 2, 7}) {
+			auto const actual = gdwg::delta_stepping(csr, 0, delta, 3);
+			REQUIRE(std::equal(expected.distances().begin(),
+			                   expected.distances().end(),
+			                   actual.distances().begin(),
+			                   actual.distances().end()));
+			for (auto v = 0; v < 300; ++v) {
+				// Walking parent links must reach the source within one step per node.
+				auto steps = 0;
+				for (auto u = static_cast<std::size_t>(v);
+				     u != decltype(actual)::no_parent and steps <= 300;
+				     u = actual.parents()[u]) {
+					++steps;
+				}
+				REQUIRE(steps <= 300);
+				auto const path = actual.path_to(v);
+				if (not actual.reachable(v)) {
+					CHECK(path.empty());
+					continue;
+				}
+				CHECK(path.front() == 0);
+				CHECK(path.back() == v);
+				auto length = 0;
+				for (auto i = std::size_t{1}; i < path.size(); ++i) {
+					auto const w = csr.weights(path[i - 1], path[i]);
+					length += *std::min_element(w.begin(), w.end());
+				}
+				CHECK(length == actual.distance(v));
+			}
+		}
+	}
+
+	SECTION("errors") {
+		auto const csr = gdwg::freeze(make_graph());
+		CHECK_THROWS_MATCHES(gdwg::delta_stepping(csr, std::string("a"), 0),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::delta_stepping with a delta "
+		                                              "that isn't positive"));
+	}
+}
@@ -0,0 +1,164 @@
+#include "gdwg/slab_resource.hpp"
+
+#include "gdwg/graph.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <memory_resource>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	// Counts the calls that reach the default resource.
+	class counting_resource : public std::pmr::memory_resource {
+	public:
+		int allocations = 0;
+		int deallocations = 0;
+
+	private:
+		auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+			++allocations;
+			return std::pmr::get_default_resource()->allocate(bytes, alignment);
+		}
+
+		auto do_deallocate(void* p, std::size_t bytes, std::size_t alignment) -> void override {
+			++deallocations;
+			std::pmr::get_default_resource()->deallocate(p, bytes, alignment);
+		}
+
+		[[nodiscard]] auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+		   -> bool override {
+			return this == &other;
+		}
+	};
+} // namespace
+
+TEST_CASE("slab_resource") {
+	auto upstream = counting_resource();
+	auto slab = gdwg::slab_resource(&upstream, 1024);
+
+	SECTION("small blocks are carved from one chunk and reused once freed") {
+		auto* a = slab.allocate(24, 8);
+		auto* b = slab.allocate(24, 8);
+		CHECK(a != b);
+		CHECK(upstream.allocations == 1);
+		slab.deallocate(a, 24, 8);
+		CHECK(slab.allocate(17, 8) == a);
+		CHECK(slab.allocate(24, 8) != a);
+		CHECK(upstream.deallocations == 0);
+	}
+
+	SECTION("chunks grow, and release returns all of them") {
+		auto blocks = std::set<void*>();
+		for (auto i = 0; i < 1000; ++i) {
+			blocks.insert(slab.allocate(48, 16));
+		}
+		CHECK(blocks.size() == 1000);
+		CHECK(upstream.allocations < 10);
+		CHECK(slab.bytes_reserved() >= 48 * 1000);
+		slab.release();
+		CHECK(upstream.deallocations == upstream.allocations);
+		CHECK(slab.bytes_reserved() == 0);
+		CHECK(slab.allocate(48, 16) != nullptr);
+		CHECK(slab.bytes_reserved() > 0);
+	}
+
+	SECTION("large or over-aligned blocks go straight upstream") {
+		auto* big = slab.allocate(gdwg::slab_resource::max_block_size + 1, 8);
+		CHECK(upstream.allocations == 1);
+		slab.deallocate(big, gdwg::slab_resource::max_block_size + 1, 8);
+		CHECK(upstream.deallocations == 1);
+		auto* aligned = slab.allocate(64, 2 * gdwg::slab_resource::granularity);
+		CHECK(upstream.allocations == 2);
+		slab.deallocate(aligned, 64, 2 * gdwg::slab_resource::granularity);
+		CHECK(slab.bytes_reserved() == 0);
+	}
+
+	CHECK(slab.is_equal(slab));
+	CHECK(not slab.is_equal(gdwg::slab_resource()));
+}
+
+TEST_CASE("Graphs allocate from their memory resource") {
+	using graph = gdwg::graph<std::string, int>;
+	auto upstream = counting_resource();
+	auto slab = gdwg::slab_resource(&upstream);
+
+	SECTION("every constructor takes a resource") {
+		auto const edges = std::vector<graph::value_type>{{"a", "b", 1}, {"b", "c", 2}};
+		auto const values = std::vector<std::string>{"x", "y"};
+		CHECK(graph(&slab).resource() == &slab);
+		CHECK(graph({"a", "b"}, &slab).resource() == &slab);
+		CHECK(graph(values.begin(), values.end(), &slab).resource() == &slab);
+		auto const g = graph(edges.begin(), edges.end(), &slab);
+		CHECK(g.resource() == &slab);
+		CHECK(g.is_connected("b", "c"));
+		CHECK(graph().resource() == std::pmr::get_default_resource());
+		CHECK(graph(g).resource() == std::pmr::get_default_resource());
+		CHECK(graph(g, &slab).resource() == &slab);
+		CHECK(graph(g, &slab) == g);
+		CHECK(upstream.allocations == 1);
+	}
+
+	SECTION("a large graph takes a handful of chunks and gives them back on release") {
+		auto rng = std::mt19937(6771);
+		auto node = std::uniform_int_distribution<int>(0, 499);
+		{
+			auto g = graph(&slab);
+			for (auto i = 0; i < 500; ++i) {
+				g.insert_node(std::to_string(i));
+			}
+			for (auto i = 0; i < 5000; ++i) {
+				g.insert_edge(std::to_string(node(rng)), std::to_string(node(rng)), i % 7);
+			}
+			for (auto i = 0; i < 100; ++i) {
+				g.erase_node(std::to_string(node(rng)));
+			}
+			CHECK(upstream.allocations < 12);
+		}
+		CHECK(upstream.deallocations == 0);
+		slab.release();
+		CHECK(upstream.deallocations == upstream.allocations);
+	}
+
+	SECTION("freed nodes and edges are reused") {
+		auto g = graph({"a", "b"}, &slab);
+		for (auto i = 0; i < 200; ++i) {
+			g.insert_edge("a", "b", i);
+		}
+		auto const reserved = slab.bytes_reserved();
+		for (auto round = 0; round < 20; ++round) {
+			for (auto i = 0; i < 200; ++i) {
+				g.erase_edge("a", "b", i);
+			}
+			for (auto i = 0; i < 200; ++i) {
+				g.insert_edge("a", "b", i);
+			}
+		}
+		CHECK(slab.bytes_reserved() == reserved);
+	}
+
+	SECTION("assignment keeps the destination's resource") {
+		auto other_slab = gdwg::slab_resource();
+		auto a = graph({"a", "b"}, &slab);
+		a.insert_edge("a", "b", 1);
+		auto b = graph({"c"}, &other_slab);
+		b = a;
+		CHECK(b.resource() == &other_slab);
+		CHECK(b == a);
+
+		auto c = graph(&slab);
+		c = std::move(b);
+		CHECK(c.resource() == &slab);
+		CHECK(c == a);
+		c.insert_edge("b", "a", 2);
+		CHECK(a.connections("b").empty());
+
+		auto d = graph(&slab);
+		d = std::move(c);
+		CHECK(d.resource() == &slab);
+		CHECK(d.is_connected("b", "a"));
+		CHECK(graph(std::move(d)).resource() == &slab);
+	}
+}
@@ -0,0 +1,183 @@
+#include "gdwg/versioned_graph.hpp"
+
+#include "gdwg/graph.hpp"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("persistent_map") {
+	using map = gdwg::detail::persistent_map<int, std::string>;
+	auto const empty = map();
+	auto const one = empty.insert_or_assign(1, "one");
+	auto const two = one.insert_or_assign(2, "two");
+	auto const replaced = two.insert_or_assign(1, "uno");
+	auto const erased = replaced.erase(2);
+
+	CHECK(empty.empty());
+	CHECK(one.size() == 1);
+	CHECK(two.size() == 2);
+	CHECK(*two.find(1) == "one");
+	CHECK(*replaced.find(1) == "uno");
+	CHECK(erased.find(2) == nullptr);
+	CHECK(two.contains(2));
+	CHECK(erased.erase(7).size() == 1);
+
+	auto keys = std::vector<int>();
+	auto many = map();
+	auto rng = std::mt19937(6771);
+	auto key = std::uniform_int_distribution<int>(0, 999);
+	for (auto i = 0; i < 2000; ++i) {
+		many = i % 3 == 0 ? many.erase(key(rng)) : many.insert_or_assign(key(rng), "");
+	}
+	for (auto const& x : many) {
+		keys.push_back(x.key);
+	}
+	CHECK(keys.size() == many.size());
+	CHECK(std::is_sorted(keys.begin(), keys.end()));
+	CHECK(std::adjacent_find(keys.begin(), keys.end()) == keys.end());
+}
+
+TEST_CASE("versioned_graph") {
+	auto g = gdwg::versioned_graph<std::string, int>{"a", "b", "c"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "b", 2);
+	g.insert_edge("b", "c", 1);
+	g.insert_edge("c", "c", 3);
+
+	SECTION("reads match graph") {
+		CHECK(g.nodes() == std::vector<std::string>{"a", "b", "c"});
+		CHECK(g.weights("a", "b") == std::vector<int>{1, 2});
+		CHECK(g.connections("a") == std::vector<std::string>{"b", "b"});
+		CHECK(g.connections_to("c") == std::vector<std::string>{"b", "c"});
+		CHECK(g.is_connected("c", "c"));
+		CHECK_FALSE(g.is_connected("c", "a"));
+		CHECK_FALSE(g.insert_edge("a", "b", 1));
+		CHECK_FALSE(g.insert_node("a"));
+
+		auto expected = gdwg::graph<std::string, int>{"a", "b", "c"};
+		expected.insert_edge("a", "b", 1);
+		expected.insert_edge("a", "b", 2);
+		expected.insert_edge("b", "c", 1);
+		expected.insert_edge("c", "c", 3);
+		CHECK(g.to_graph() == expected);
+		CHECK(gdwg::versioned_graph<std::string, int>(expected).to_graph() == expected);
+	}
+
+	SECTION("snapshots don't see later changes") {
+		auto const before = g.snapshot();
+		g.erase_edge("a", "b", 1);
+		g.erase_node("c");
+		g.insert_node("d");
+		g.insert_edge("d", "a", 4);
+
+		CHECK(before.nodes() == std::vector<std::string>{"a", "b", "c"});
+		CHECK(before.weights("a", "b") == std::vector<int>{1, 2});
+		CHECK(before.connections_to("c") == std::vector<std::string>{"b", "c"});
+		CHECK_FALSE(before.is_node("d"));
+
+		CHECK(g.nodes() == std::vector<std::string>{"a", "b", "d"});
+		CHECK(g.weights("a", "b") == std::vector<int>{2});
+		CHECK(g.connections("b").empty());
+		CHECK(g.connections_to("a") == std::vector<std::string>{"d"});
+	}
+
+	SECTION("replace_node and merge_replace_node") {
+		auto const before = g.snapshot();
+		CHECK(g.replace_node("c", "e"));
+		CHECK_FALSE(g.replace_node("a", "b"));
+		CHECK(g.connections_to("e") == std::vector<std::string>{"b", "e"});
+		g.merge_replace_node("a", "b");
+		CHECK(g.nodes() == std::vector<std::string>{"b", "e"});
+		CHECK(g.weights("b", "b") == std::vector<int>{1, 2});
+		CHECK(before.to_graph().nodes() == std::vector<std::string>{"a", "b", "c"});
+	}
+
+	SECTION("exceptions") {
+		CHECK_THROWS_MATCHES(g.insert_edge("a", "z", 1),
+		                     std::runtime_error,
+		                     Catch::Matchers::Message("Cannot call gdwg::versioned_graph<N, E>::"
+		                                              "insert_edge when either src or dst node does "
+		                                              "not exist"));
+		CHECK_THROWS_AS(g.erase_edge("z", "a", 1), std::runtime_error);
+		CHECK_THROWS_AS(g.replace_node("z", "y"), std::runtime_error);
+		CHECK_THROWS_AS(g.merge_replace_node("a", "z"), std::runtime_error);
+		CHECK_THROWS_AS(g.snapshot().weights("a", "z"), std::runtime_error);
+	}
+}
+
+TEST_CASE("versioned_graph matches graph under random changes") {
+	auto rng = std::mt19937(6771);
+	auto node = std::uniform_int_distribution<int>(0, 49);
+	auto weight = std::uniform_int_distribution<int>(0, 2);
+	auto op = std::uniform_int_distribution<int>(0, 9);
+	auto expected = gdwg::graph<int, int>();
+	auto g = gdwg::versioned_graph<int, int>();
+	auto history = std::vector<std::pair<gdwg::graph_snapshot<int, int>, gdwg::graph<int, int>>>();
+
+	for (auto i = 0; i < 3000; ++i) {
+		auto const a = node(rng);
+		auto const b = node(rng);
+		auto const w = weight(rng);
+		switch (op(rng)) {
+		case 0: CHECK(g.erase_node(a) == expected.erase_node(a)); break;
+		case 1:
+			if (expected.is_node(a) and expected.is_node(b)) {
+				expected.merge_replace_node(a, b);
+				g.merge_replace_node(a, b);
+			}
+			break;
+		case 2:
+		case 3:
+			if (expected.is_node(a) and expected.is_node(b)) {
+				CHECK(g.erase_edge(a, b, w) == expected.erase_edge(a, b, w));
+			}
+			break;
+		default:
+			CHECK(g.insert_node(a) == expected.insert_node(a));
+			g.insert_node(b);
+			expected.insert_node(b);
+			CHECK(g.insert_edge(a, b, w) == expected.insert_edge(a, b, w));
+		}
+		if (i % 300 == 0) {
+			history.emplace_back(g.snapshot(), expected);
+		}
+	}
+	CHECK(g.to_graph() == expected);
+	for (auto const n : expected.nodes()) {
+		CHECK(g.connections_to(n) == expected.connections_to(n));
+	}
+	for (auto const& [snapshot, then] : history) {
+		CHECK(snapshot.to_graph() == then);
+	}
+}
+
+TEST_CASE("snapshots can be read while the graph changes") {
+	auto g = gdwg::versioned_graph<int, int>();
+	for (auto i = 0; i < 100; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 100; ++i) {
+		g.insert_edge(i, (i + 1) % 100, 0);
+	}
+	auto const snapshot = g.snapshot();
+	auto edges_seen = 0;
+	{
+		auto reader = std::jthread([&snapshot, &edges_seen] {
+			for (auto round = 0; round < 20; ++round) {
+				for ([[maybe_unused]] auto const& e : snapshot) {
+					++edges_seen;
+				}
+			}
+		});
+		for (auto i = 0; i < 100; ++i) {
+			g.erase_node(i);
+		}
+	}
+	CHECK(edges_seen == 20 * 100);
+	CHECK(g.empty());
+	CHECK(snapshot.nodes().size() == 100);
+}
@@ -0,0 +1,107 @@
+#include "gdwg/graph.hpp"
+
+#include "counting_allocator.hpp"
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <range/v3/range/traits.hpp>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+	using graph = gdwg::graph<std::string, int>;
+
+	auto make_graph() -> graph {
+		auto const v = std::vector<graph::value_type>{
+		   {"a long node name that won't fit in a small string", "b", 2},
+		   {"a long node name that won't fit in a small string", "b", 1},
+		   {"a long node name that won't fit in a small string", "c", 3},
+		   {"c", "a long node name that won't fit in a small string", 4},
+		   {"b", "c", 5},
+		};
+		auto g = graph(v.begin(), v.end());
+		g.insert_node("d");
+		return g;
+	}
+
+	template<typename Range>
+	auto collect(Range const& r) {
+		auto result = std::vector<std::remove_cvref_t<ranges::range_reference_t<Range const>>>();
+		for (auto const& x : r) {
+			result.push_back(x);
+		}
+		return result;
+	}
+} // namespace
+
+TEST_CASE("Range views match the vector accessors") {
+	auto const g = make_graph();
+	auto const big = std::string("a long node name that won't fit in a small string");
+
+	CHECK(collect(g.nodes_view()) == g.nodes());
+	for (auto const& x : g.nodes()) {
+		CHECK(collect(g.connections_view(x)) == g.connections(x));
+		CHECK(collect(g.connections_to_view(x)) == g.connections_to(x));
+		for (auto const& y : g.nodes()) {
+			CHECK(collect(g.weights_view(x, y)) == g.weights(x, y));
+		}
+	}
+	CHECK(collect(g.weights_view(big, "b")) == std::vector<int>{1, 2});
+	CHECK(collect(g.connections_view("d")).empty());
+
+	static_assert(std::is_same_v<ranges::range_reference_t<decltype(g.nodes_view())>,
+	                             std::string const&>);
+	static_assert(std::is_same_v<ranges::range_reference_t<decltype(g.connections_view(big))>,
+	                             std::string const&>);
+	static_assert(std::is_same_v<ranges::range_reference_t<decltype(g.connections_to_view(big))>,
+	                             std::string const&>);
+	static_assert(std::is_same_v<ranges::range_reference_t<decltype(g.weights_view(big, big))>,
+	                             int const&>);
+}
+
+TEST_CASE("Range views refer into the graph") {
+	auto const g = make_graph();
+	auto const big = std::string("a long node name that won't fit in a small string");
+	auto const* stored = &*g.nodes_view().begin();
+	CHECK(*stored == big);
+	CHECK(&*g.connections_view("c").begin() == stored);
+	CHECK(&*g.connections_to_view("b").begin() == stored);
+}
+
+TEST_CASE("Iterating range views allocates nothing") {
+	auto const g = make_graph();
+	auto const big = std::string("a long node name that won't fit in a small string");
+	auto const before = gdwg::test::allocations();
+	auto length = std::size_t{0};
+	auto total = 0;
+	for (auto const& x : g.nodes_view()) {
+		for (auto const& y : g.connections_view(x)) {
+			length += y.size();
+		}
+		for (auto const& y : g.connections_to_view(x)) {
+			length += y.size();
+		}
+	}
+	for (auto const w : g.weights_view(big, "b")) {
+		total += w;
+	}
+	CHECK(gdwg::test::allocations() == before);
+	CHECK(length == 6 + 4 * big.size());
+	CHECK(total == 3);
+	CHECK(not g.nodes().empty());
+	CHECK(gdwg::test::allocations() > before);
+}
+
+TEST_CASE("Range views check their nodes exist") {
+	auto const g = make_graph();
+	CHECK_THROWS_WITH(g.connections_view("z"),
+	                  "Cannot call gdwg::graph<N, E>::connections_view if src doesn't exist in the "
+	                  "graph");
+	CHECK_THROWS_WITH(g.connections_to_view("z"),
+	                  "Cannot call gdwg::graph<N, E>::connections_to_view if dst doesn't exist in "
+	                  "the graph");
+	CHECK_THROWS_WITH(g.weights_view("d", "z"),
+	                  "Cannot call gdwg::graph<N, E>::weights_view if src or dst node don't exist "
+	                  "in the graph");
+}